@@ -4,6 +4,9 @@
 #include "classes/Checkers.h"
 #include "classes/Othello.h"
 #include "classes/Chess.h"
+#include "classes/MoveGen.h"
+#include "classes/Nnue.h"
+#include "classes/PolyglotBook.h"
 
 namespace ClassGame {
         //
@@ -20,6 +23,14 @@ namespace ClassGame {
         void GameStartUp() 
         {
             game = nullptr;
+            // chess sliding-piece attack tables
+            initMoveGenTables();
+            // optional network; without it the AI uses the piece-square evaluation
+            loadNnue("resources/chess.nnue");
+            // optional opening book; its keys need the Polyglot random table (see PolyglotBook.h)
+            if (loadPolyglotRandom("resources/polyglot_random64.txt")) {
+                loadBook("resources/book.bin");
+            }
         }
 
         //
@@ -61,6 +72,17 @@ namespace ClassGame {
                         game = new Chess();
                         game->setUpBoard();
                     }
+                    if (ImGui::Button("Start Chess vs AI")) {
+                        game = new Chess();
+                        game->_gameOptions.AIPlaying = true;
+                        game->_gameOptions.AIPlayer = AI_PLAYER;
+                        game->setUpBoard();
+                    }
+                    if (ImGui::Button("Start Chess AI vs AI")) {
+                        game = new Chess();
+                        game->_gameOptions.AIvsAI = true;
+                        game->setUpBoard();
+                    }
                 } else {
                     ImGui::Text("Current Player Number: %d", game->getCurrentPlayer()->playerNumber());
                     std::string stateString = game->stateString();
@@ -71,12 +93,30 @@ namespace ClassGame {
                         ImGui::Text("%s", stateString.substr(y*stride,stride).c_str());
                     }
                     ImGui::Text("Current Board State: %s", game->stateString().c_str());
+                    if (dynamic_cast<Chess*>(game)) {
+                        ImGui::SliderInt("AI Move Time ms (0 = depth only)", &game->_gameOptions.AIMoveTimeMs, 0, 10000);
+                        ImGui::SliderInt("AI Max Depth (0 = default)", &game->_gameOptions.AIMAXDepth, 0, 20);
+                        ImGui::InputInt("AI Node Limit (0 = none)", &game->_gameOptions.AIDepthSearches, 10000);
+                        ImGui::SliderInt("AI Threads", &game->_gameOptions.AIThreads, 1,
+                                         std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+                        ImGui::SliderInt("AI Slice ms per frame (0 = worker thread)", &game->_gameOptions.AISliceMs, 0, 16);
+                        ImGui::Checkbox("AI Ponder (think on your time)", &game->_gameOptions.AIPonder);
+                        ImGui::SliderInt("AI Speculate on N replies (0 = off)", &game->_gameOptions.AISpeculate, 0,
+                                         std::min(ReplySpeculator::MaxReplies, std::max(1, static_cast<int>(std::thread::hardware_concurrency()))));
+                        if (openingBook().isOpen()) {
+                            ImGui::Checkbox("AI Use Opening Book", &game->_gameOptions.AIUseBook);
+                            ImGui::Checkbox("Book: always the best move", &game->_gameOptions.AIBookBest);
+                        }
+                        ImGui::Checkbox("AI vs AI", &game->_gameOptions.AIvsAI);
+                        const std::string status = static_cast<Chess*>(game)->aiStatus();
+                        if (!status.empty()) ImGui::TextWrapped("%s", status.c_str());
+                    }
                 }
                 ImGui::End();
 
                 ImGui::Begin("GameWindow");
                 if (game) {
-                    if (game->gameHasAI() && (game->getCurrentPlayer()->isAIPlayer() || game->_gameOptions.AIvsAI))
+                    if (!gameOver && game->gameHasAI() && (game->getCurrentPlayer()->isAIPlayer() || game->_gameOptions.AIvsAI))
                     {
                         game->updateAI();
                     }
@@ -3,6 +3,7 @@
 #ifdef _MSC_VER
 #include <intrin.h>
 #endif
+#include <cstdint>
 #include <iostream>
 
 enum ChessPiece
@@ -16,6 +17,32 @@ enum ChessPiece
     King
 };
 
+// Free-standing bit helpers used by the bitboard move generator
+inline int bitScanForward(uint64_t bb) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, bb);
+    return index;
+#else
+    return __builtin_ctzll(bb);
+#endif
+}
+
+inline int popCount(uint64_t bb) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (int)__popcnt64(bb);
+#else
+    return __builtin_popcountll(bb);
+#endif
+}
+
+// Returns the index of the lowest set bit and clears it
+inline int popLSB(uint64_t& bb) {
+    const int index = bitScanForward(bb);
+    bb &= bb - 1;
+    return index;
+}
+
 class BitboardElement {
   public:
     // Constructors
@@ -80,19 +107,57 @@ private:
 
 };
 
+// Move flags stored in the top 4 bits of a BitMove
+enum MoveFlag
+{
+    QuietMove          = 0,
+    DoublePawnPush     = 1,
+    KingCastle         = 2,
+    QueenCastle        = 3,
+    CaptureMove        = 4,
+    EnPassantCapture   = 5,
+    KnightPromotion    = 8,
+    BishopPromotion    = 9,
+    RookPromotion      = 10,
+    QueenPromotion     = 11,
+    KnightPromoCapture = 12,
+    BishopPromoCapture = 13,
+    RookPromoCapture   = 14,
+    QueenPromoCapture  = 15
+};
+
+//
+// 16-bit packed move: bits 0-5 from square, bits 6-11 to square, bits 12-15 MoveFlag.
+// The moving piece is not stored; look it up in the position (Position::pieceAt(from)).
+// A zero word is "no move" (a1a1 can never be a real move).
+//
 struct BitMove {
-    uint8_t from;
-    uint8_t to;
-    uint8_t piece;
-    
-    BitMove(int from, int to, ChessPiece piece)
-        : from(from), to(to), piece(piece) { }
-        
-    BitMove() : from(0), to(0), piece(NoPiece) { }
-    
-    bool operator==(const BitMove& other) const {
-        return from == other.from && 
-               to == other.to && 
-               piece == other.piece;
+    uint16_t data;
+
+    BitMove() = default;
+    constexpr BitMove(int from, int to, MoveFlag flags = QuietMove)
+        : data(static_cast<uint16_t>(from | (to << 6) | (flags << 12))) { }
+
+    static constexpr BitMove none() { return fromRaw(0); }
+    static constexpr BitMove fromRaw(uint16_t raw) { BitMove m(0, 0); m.data = raw; return m; }
+    constexpr uint16_t raw() const { return data; }
+
+    constexpr int from() const { return data & 0x3F; }
+    constexpr int to() const { return (data >> 6) & 0x3F; }
+    constexpr MoveFlag flags() const { return static_cast<MoveFlag>(data >> 12); }
+
+    constexpr bool isNull() const { return data == 0; }
+    constexpr bool isCapture() const { return (flags() & CaptureMove) != 0; }
+    constexpr bool isPromotion() const { return (flags() & KnightPromotion) != 0; }
+    constexpr bool isCastle() const { return flags() == KingCastle || flags() == QueenCastle; }
+    constexpr bool isEnPassant() const { return flags() == EnPassantCapture; }
+    // Knight..Queen for promotions, NoPiece otherwise
+    constexpr ChessPiece promotionPiece() const {
+        return isPromotion() ? static_cast<ChessPiece>(Knight + (flags() & 3)) : NoPiece;
     }
-};
\ No newline at end of file
+
+    constexpr bool operator==(const BitMove& other) const { return data == other.data; }
+    constexpr bool operator!=(const BitMove& other) const { return data != other.data; }
+};
+
+static_assert(sizeof(BitMove) == 2, "BitMove must pack into 16 bits");
@@ -1,48 +1,40 @@
 #include "Chess.h"
+#include "MoveGen.h"
+#include "PolyglotBook.h"
 #include <limits>
+#include <chrono>
 #include <cmath>
 #include <sstream>
 #include <cctype>
 #include <algorithm>
-
-// Helpers for move generation
-static inline bool isWhitePieceChar(char c) {
-    return std::isupper(static_cast<unsigned char>(c)) != 0;
-}
-
-static inline bool isBlackPieceChar(char c) {
-    return std::islower(static_cast<unsigned char>(c)) != 0;
-}
-
-static inline bool isFriendly(char pieceChar, char color) {
-    const char c = static_cast<char>(std::tolower(static_cast<unsigned char>(color)));
-    return (c == 'w') ? isWhitePieceChar(pieceChar) : isBlackPieceChar(pieceChar);
-}
-
-static inline bool isEnemy(char pieceChar, char color) {
-    const char c = static_cast<char>(std::tolower(static_cast<unsigned char>(color)));
-    return (c == 'w') ? isBlackPieceChar(pieceChar) : isWhitePieceChar(pieceChar);
-}
-
-static inline ChessPiece pieceFromStateChar(char c) {
-    switch (std::tolower(static_cast<unsigned char>(c))) {
-        case 'p': return Pawn;
-        case 'n': return Knight;
-        case 'b': return Bishop;
-        case 'r': return Rook;
-        case 'q': return Queen;
-        case 'k': return King;
-        default:  return NoPiece;
-    }
-}
+#include <iterator>
 
 Chess::Chess()
 {
     _grid = new Grid(8, 8);
+    // no depth cap: the per-move time budget decides how deep the AI goes
+    _gameOptions.AIMAXDepth = 0;
+    _gameOptions.AIDepthSearches = 0;
+
+    // runs on the AI worker (the search's main thread), the queue's only producer; in
+    // time-sliced mode the UI thread is both producer and consumer
+    const auto report = [this](const SearchResult& result) {
+        AIProgress progress;
+        progress.depth = result.depth;
+        progress.score = result.score;
+        progress.nodes = result.nodes;
+        progress.seconds = result.seconds;
+        progress.pvLength = static_cast<int>(std::min(result.pv.size(), std::size(progress.pv)));
+        std::copy(result.pv.begin(), result.pv.begin() + progress.pvLength, progress.pv);
+        _aiProgress.push(progress);
+    };
+    _search.setIterationCallback(report);
+    _slicedSearch.setIterationCallback(report);
 }
 
 Chess::~Chess()
 {
+    stopAI();
     delete _grid;
 }
 
@@ -50,10 +42,11 @@ char Chess::pieceNotation(int x, int y) const
 {
     const char *wpieces = { "0PNBRQK" };
     const char *bpieces = { "0pnbrqk" };
-    Bit *bit = _grid->getSquare(x, y)->bit();
+    // Position piece codes use the same layout as the Bit game tags
+    const uint8_t code = _position.pieceAt(y * 8 + x);
     char notation = '0';
-    if (bit) {
-        notation = bit->gameTag() < 128 ? wpieces[bit->gameTag()] : bpieces[bit->gameTag() - 128];
+    if (code) {
+        notation = code < 128 ? wpieces[code] : bpieces[code - 128];
     }
     return notation;
 }
@@ -79,6 +72,7 @@ Bit* Chess::PieceForPlayer(const int playerNumber, ChessPiece piece)
 
 void Chess::setUpBoard()
 {
+    stopAI();
     setNumberOfPlayers(2);
     _gameOptions.rowX = 8;
     _gameOptions.rowY = 8;
@@ -87,8 +81,15 @@ void Chess::setUpBoard()
 
     // Standard start position (works with board-only or full FEN)
     FENtoBoard("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    _tt.clear();
+
+    // RenderGame sets AIPlaying/AIPlayer (or AIvsAI) before calling setUpBoard
+    if (_gameOptions.AIPlaying) {
+        setAIPlayer(_gameOptions.AIPlayer);
+    }
 
     startGame();
+    _turns.back()->_zobristKey = _position.key();
 }
 
 void Chess::FENtoBoard(const std::string& fen)
@@ -98,272 +99,33 @@ void Chess::FENtoBoard(const std::string& fen)
         if (square && square->bit()) square->destroyBit();
     });
 
-    // 2) Take only the piece placement field (first space-delimited token)
-    std::string placement;
-    {
-        std::istringstream iss(fen);
-        iss >> placement;
-    }
-    if (placement.empty()) return;
-
-    // 3) Parse ranks 8 -> 1, left to right
-    // In this project, y=0 is the TOP of the board, so rank 8 maps to y=0.
-    int x = 0;
-    int y = 0;
-
-    for (char c : placement)
-    {
-        if (c == '/') {
-            y++;
-            x = 0;
-            if (y >= 8) break;
-            continue;
-        }
-
-        if (c >= '1' && c <= '8') {
-            x += (c - '0');
-            continue;
-        }
-
-        ChessPiece piece = NoPiece;
-        int playerNumber = 0; // 0 = white, 1 = black
-
-        switch (c)
-        {
-            // White
-            case 'P': piece = Pawn;   playerNumber = 0; break;
-            case 'N': piece = Knight; playerNumber = 0; break;
-            case 'B': piece = Bishop; playerNumber = 0; break;
-            case 'R': piece = Rook;   playerNumber = 0; break;
-            case 'Q': piece = Queen;  playerNumber = 0; break;
-            case 'K': piece = King;   playerNumber = 0; break;
-
-            // Black
-            case 'p': piece = Pawn;   playerNumber = 1; break;
-            case 'n': piece = Knight; playerNumber = 1; break;
-            case 'b': piece = Bishop; playerNumber = 1; break;
-            case 'r': piece = Rook;   playerNumber = 1; break;
-            case 'q': piece = Queen;  playerNumber = 1; break;
-            case 'k': piece = King;   playerNumber = 1; break;
-
-            default:
-                break;
-        }
-
-        if (piece != NoPiece && x >= 0 && x < 8 && y >= 0 && y < 8)
-        {
-            ChessSquare* square = _grid->getSquare(x, 7 - y);
-            if (square) {
-                Bit* b = PieceForPlayer(playerNumber, piece);
-                // Use dropBitAtPoint so the sprite snaps to the square correctly
-                square->dropBitAtPoint(b, ImVec2(0, 0));
-            }
-        }
-
-        x++;
-        if (x > 8) x = 8;
-    }
-}
-
-static inline void addRayMoves(std::vector<BitMove>& moves, const char* state, char color, int from, ChessPiece piece, int dx, int dy)
-{
-    int fx = from % 8;
-    int fy = from / 8;
-
-    int x = fx + dx;
-    int y = fy + dy;
-
-    while (x >= 0 && x < 8 && y >= 0 && y < 8) {
-        int to = y * 8 + x;
-        char dst = state[to];
-
-        if (dst == '0') {
-            moves.emplace_back(from, to, piece);
-        } else {
-            if (isEnemy(dst, color)) {
-                moves.emplace_back(from, to, piece); // capture
-            }
-            break; // stop on first piece either way
-        }
+    // 2) Parse into the bitboard position (works with board-only or full FEN)
+    _lastFrom = -1;
+    if (!_position.setFEN(fen)) return;
 
-        x += dx;
-        y += dy;
-    }
+    // 3) Create a sprite for every piece. Square index is y*8+x with y=0 the bottom (rank 1).
+    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
+        const uint8_t code = _position.pieceAt(y * 8 + x);
+        if (!code || !square) return;
+        Bit* b = PieceForPlayer(pieceColorOf(code), pieceTypeOf(code));
+        // Use dropBitAtPoint so the sprite snaps to the square correctly
+        square->dropBitAtPoint(b, ImVec2(0, 0));
+    });
 }
 
 // Move generation
-std::vector<BitMove> Chess::generateMoves(const char* state, char color)
-{
-    std::vector<BitMove> moves;
-    moves.reserve(40);
-    if (!state) return moves;
-
-    // Build a bitboard of friendly occupancy (for filtering attacks)
-    uint64_t friendly = 0ULL;
-    for (int i = 0; i < 64; i++) {
-        const char pc = state[i];
-        if (pc == '0') continue;
-        if (isFriendly(pc, color)) friendly |= (1ULL << i);
-    }
-
-    // Precompute attack tables once
-    static uint64_t KNIGHT_ATK[64];
-    static uint64_t KING_ATK[64];
-    static bool tablesInit = false;
-
-    if (!tablesInit) {
-        const uint64_t notA  = 0xfefefefefefefefeULL;
-        const uint64_t notH  = 0x7f7f7f7f7f7f7f7fULL;
-        const uint64_t notAB = 0xfcfcfcfcfcfcfcfcULL;
-        const uint64_t notGH = 0x3f3f3f3f3f3f3f3fULL;
-
-        for (int sq = 0; sq < 64; sq++) {
-            const uint64_t b = 1ULL << sq;
-
-            uint64_t n = 0ULL;
-            n |= (b << 17) & notA;
-            n |= (b << 15) & notH;
-            n |= (b << 10) & notAB;
-            n |= (b << 6)  & notGH;
-            n |= (b >> 17) & notH;
-            n |= (b >> 15) & notA;
-            n |= (b >> 10) & notGH;
-            n |= (b >> 6)  & notAB;
-            KNIGHT_ATK[sq] = n;
-
-            uint64_t k = 0ULL;
-            k |= (b << 8);
-            k |= (b >> 8);
-            k |= (b << 1) & notA;
-            k |= (b >> 1) & notH;
-            k |= (b << 9) & notA;
-            k |= (b << 7) & notH;
-            k |= (b >> 7) & notA;
-            k |= (b >> 9) & notH;
-            KING_ATK[sq] = k;
-        }
-
-        tablesInit = true;
-    }
-
-    const bool isWhite = (std::tolower(static_cast<unsigned char>(color)) == 'w');
-
-    // Board coordinates in your project: y=0 is the BOTTOM.
-    // White moves toward higher y, black moves toward lower y.
-    const int pawnDir = isWhite ? 1 : -1;
-
-    // White pawns start on rank 2 => y=1
-    // Black pawns start on rank 7 => y=6
-    const int pawnStartRank = isWhite ? 1 : 6;
-
-    for (int from = 0; from < 64; from++) {
-        const char pc = state[from];
-        if (pc == '0') continue;
-        if (!isFriendly(pc, color)) continue;
-
-        const ChessPiece p = pieceFromStateChar(pc);
-        const int fx = from % 8;
-        const int fy = from / 8;
-
-        // PAWNS
-        if (p == Pawn) {
-            // forward one
-            const int ny = fy + pawnDir;
-            if (ny >= 0 && ny < 8) {
-                const int one = ny * 8 + fx;
-                if (state[one] == '0') {
-                    moves.emplace_back(from, one, Pawn);
-
-                    // forward two from starting rank (must have empty one and empty two)
-                    if (fy == pawnStartRank) {
-                        const int nny = fy + 2 * pawnDir;
-                        if (nny >= 0 && nny < 8) {
-                            const int two = nny * 8 + fx;
-                            if (state[two] == '0') {
-                                moves.emplace_back(from, two, Pawn);
-                            }
-                        }
-                    }
-                }
-            }
-
-            // captures diagonally
-            const int cy = fy + pawnDir;
-            if (cy >= 0 && cy < 8) {
-                if (fx - 1 >= 0) {
-                    const int to = cy * 8 + (fx - 1);
-                    if (isEnemy(state[to], color)) moves.emplace_back(from, to, Pawn);
-                }
-                if (fx + 1 < 8) {
-                    const int to = cy * 8 + (fx + 1);
-                    if (isEnemy(state[to], color)) moves.emplace_back(from, to, Pawn);
-                }
-            }
-
-            continue;
-        }
-
-        // KNIGHTS
-        if (p == Knight) {
-            BitboardElement atk(KNIGHT_ATK[from] & ~friendly);
-            atk.forEachBit([&](int to) {
-                moves.emplace_back(from, to, Knight);
-            });
-            continue;
-        }
-
-        // KING
-        if (p == King) {
-            BitboardElement atk(KING_ATK[from] & ~friendly);
-            atk.forEachBit([&](int to) {
-                moves.emplace_back(from, to, King);
-            });
-            continue;
-        }
-
-        // ROOKS
-        if (p == Rook) {
-            addRayMoves(moves, state, color, from, Rook,  1,  0);
-            addRayMoves(moves, state, color, from, Rook, -1,  0);
-            addRayMoves(moves, state, color, from, Rook,  0,  1);
-            addRayMoves(moves, state, color, from, Rook,  0, -1);
-            continue;
-        }
-
-        // BISHOPS
-        if (p == Bishop) {
-            addRayMoves(moves, state, color, from, Bishop,  1,  1);
-            addRayMoves(moves, state, color, from, Bishop, -1,  1);
-            addRayMoves(moves, state, color, from, Bishop,  1, -1);
-            addRayMoves(moves, state, color, from, Bishop, -1, -1);
-            continue;
-        }
-
-        // QUEENS (rook + bishop directions)
-        if (p == Queen) {
-            // rook-like
-            addRayMoves(moves, state, color, from, Queen,  1,  0);
-            addRayMoves(moves, state, color, from, Queen, -1,  0);
-            addRayMoves(moves, state, color, from, Queen,  0,  1);
-            addRayMoves(moves, state, color, from, Queen,  0, -1);
-
-            // bishop-like
-            addRayMoves(moves, state, color, from, Queen,  1,  1);
-            addRayMoves(moves, state, color, from, Queen, -1,  1);
-            addRayMoves(moves, state, color, from, Queen,  1, -1);
-            addRayMoves(moves, state, color, from, Queen, -1, -1);
-            continue;
-        }
-
-    }
-
-    return moves;
+// Pseudo-legal: may leave the king in check
+void Chess::generateMoves(const Position& pos, MoveList& moves)
+{
+    moves.clear();
+    generatePseudoLegalMoves(pos, moves);
 }
 
-std::vector<BitMove> Chess::generateAllMoves(const char* state, char color)
+void Chess::generateAllMoves(const Position& pos, MoveList& moves)
 {
-    // For right now, this is the full generator.
-    return generateMoves(state, color);
+    // Legal moves only, so the UI never offers a move that leaves the king in check
+    moves.clear();
+    generateLegalMoves(pos, moves);
 }
 
 void Chess::clearBoardHighlights()
@@ -385,23 +147,14 @@ bool Chess::actionForEmptyHolder(BitHolder &holder)
     return false;
 }
 
-static std::string boardPrettyFromState(const std::string& s)
-{
-    std::string out;
-    out.reserve(8 * 9);
-
-    // Print top row first for humans (rank 8 down to 1)
-    for (int y = 7; y >= 0; y--) {
-        for (int x = 0; x < 8; x++) {
-            out += s[y * 8 + x];
-        }
-        out += '\n';
-    }
-    return out;
-}
-
 bool Chess::canBitMoveFrom(Bit &bit, BitHolder &src)
 {
+    // the AI plays both sides; a search is running on a copy of this position
+    if (_gameOptions.AIvsAI) return false;
+    // a human taking over (AI vs AI switched off mid-search) cancels the AI's move;
+    // ponder and speculative searches are for the AI's next move and keep running
+    if (!_aiPondering && !_speculator.active()) stopAI();
+
     // Clear old highlights
     clearBoardHighlights();
     _highlightsActive = false;
@@ -416,32 +169,18 @@ bool Chess::canBitMoveFrom(Bit &bit, BitHolder &src)
     if (!srcSq) return true; // allow drag, just no highlights
 
     const int from = srcSq->getSquareIndex();
-    const char color = (getCurrentPlayer()->playerNumber() == 0) ? 'w' : 'b';
-
-    // Generate moves for current position
-    std::string s = stateString();
-    std::vector<BitMove> moves = generateAllMoves(s.c_str(), color);
 
-    // VS Code Debug Console output (run with debugger)
-    std::cout << "\n=== MoveGen Debug ===\n";
-    std::cout << "Player color: " << color << "\n";
-    std::cout << "Board:\n" << boardPrettyFromState(s);
-    std::cout << "Total moves: " << moves.size() << "\n";
-
-    // show first 20 moves (assignment wants 20)
-    for (int i = 0; i < (int)moves.size() && i < 20; i++) {
-        std::cout << i << ": " << moves[i].from << " -> " << moves[i].to
-                  << " piece=" << (int)moves[i].piece << "\n";
-    }
-    std::cout << "=====================\n";
-    std::cout << std::flush;
+    // Generate moves for current position (kept for canBitMoveFromTo while dragging)
+    MoveList& moves = _lastMoves;
+    generateAllMoves(_position, moves);
+    _lastFrom = from;
 
     // Highlight destination squares for this piece
     bool anyHighlighted = false;
     for (const BitMove& m : moves) {
-        if (m.from == from) {
-            int tx = m.to % 8;
-            int ty = m.to / 8;
+        if (m.from() == from) {
+            int tx = m.to() % 8;
+            int ty = m.to() / 8;
             auto* dstSq = _grid->getSquare(tx, ty);
             if (dstSq) {
                 dstSq->setHighlighted(true);
@@ -449,7 +188,7 @@ bool Chess::canBitMoveFrom(Bit &bit, BitHolder &src)
             }
         }
     }
-_highlightsActive = anyHighlighted;
+    _highlightsActive = anyHighlighted;
     return true;
 }
 
@@ -463,6 +202,18 @@ void Chess::drawFrame()
     if (_highlightsActive && _dragBit == nullptr) {
         clearBoardHighlights();
     }
+
+    // updateAI() only runs on the AI's turn, so the ponder search's reports are collected here
+    if (_aiPondering && !_ponderFinished) {
+        AIProgress progress;
+        while (_aiProgress.pop(progress)) {
+            if (progress.finished) {
+                _ponderFinished = true;
+                break;
+            }
+            _aiStatus = progress;
+        }
+    }
 }
 
 bool Chess::clickedBit(Bit &bit)
@@ -485,9 +236,403 @@ void Chess::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
         dst.destroyBit();       // remove captured piece
     }
 
+    // Keep the bitboard position in sync with the sprites
+    auto* srcSq = dynamic_cast<ChessSquare*>(&src);
+    auto* dstSq = dynamic_cast<ChessSquare*>(&dst);
+    BitMove move = BitMove::none();
+    if (srcSq && dstSq) {
+        move = findMove(srcSq->getSquareIndex(), dstSq->getSquareIndex());
+    }
+    // "bit" must not be used after this: a promoted pawn's sprite is replaced
+    commitMove(move);
+    resolvePonder(move);
+}
+
+// Castling rook, en passant pawn and promotion sprites, then the position and the turn record.
+// The moving piece's sprite must already be on the destination square.
+void Chess::commitMove(const BitMove& move)
+{
+    if (!move.isNull()) {
+        applySpecialMoveSprites(move);
+        _position.makeMove(move);
+    }
+    _lastFrom = -1; // cached move list is stale now
+
     // Turn is over after one move
     clearBoardHighlights();
     endTurn();
+    _turns.back()->_move = moveToUCI(move);
+    _turns.back()->_moveCode = move.raw();
+    _turns.back()->_zobristKey = _position.key();
+}
+
+// Play a move for the AI: slide the sprite the same way a mouse drop does, then commit it
+void Chess::playMove(const BitMove& move)
+{
+    ChessSquare* src = _grid->getSquareByIndex(move.from());
+    ChessSquare* dst = _grid->getSquareByIndex(move.to());
+    Bit* bit = src ? src->bit() : nullptr;
+    if (!bit || !dst) return;
+
+    if (dst->bit()) {
+        pieceTaken(dst->bit());
+    }
+    dst->dropBitAtPoint(bit, bit->getPosition());
+    src->draggedBitTo(bit, dst);
+    commitMove(move);
+}
+
+// Starts the worker on the first call of a turn, then collects its reports once per frame
+void Chess::updateAI()
+{
+    if (_speculationHit) {
+        takeSpeculation();
+        return;
+    }
+    if (!_aiThinking) {
+        startAI();
+        return;
+    }
+
+    if (_aiSliced) {
+        stepAI();
+        return;
+    }
+    // a ponder search that ended on its own (depth cap, forced mate) before the hit
+    if (_ponderFinished) {
+        _ponderFinished = false;
+        finishAI();
+        return;
+    }
+
+    AIProgress progress;
+    while (_aiProgress.pop(progress)) {
+        if (progress.finished) {
+            finishAI();
+            return;
+        }
+        _aiStatus = progress;
+    }
+}
+
+// Limits for one AI move: a timed move searches as deep as the budget allows unless a depth cap is set
+SearchLimits Chess::aiLimits() const
+{
+    SearchLimits limits;
+    limits.moveTimeMs = _gameOptions.AIMoveTimeMs;
+    limits.maxDepth = _gameOptions.AIMAXDepth > 0 ? _gameOptions.AIMAXDepth : (limits.moveTimeMs > 0 ? MaxPly : 4);
+    limits.maxNodes = _gameOptions.AIDepthSearches > 0 ? static_cast<uint64_t>(_gameOptions.AIDepthSearches) : 0;
+    return limits;
+}
+
+// The book's move for the current position, or a null move when there is none (or no book)
+BitMove Chess::bookMove()
+{
+    if (!_gameOptions.AIUseBook) return BitMove::none();
+    const PolyglotBook::Selection selection = _gameOptions.AIBookBest ? PolyglotBook::BestMove : PolyglotBook::Weighted;
+    return openingBook().pick(_position, selection, _bookRandom());
+}
+
+void Chess::startAI()
+{
+    // the opening book is consulted first; a book move is played without searching
+    const BitMove fromBook = bookMove();
+    if (!fromBook.isNull()) {
+        std::cout << "AI book move " << moveToUCI(fromBook) << std::endl;
+        playMove(fromBook);
+        return;
+    }
+
+    const SearchLimits limits = aiLimits();
+    _aiThinking = true;
+    _aiStatus = AIProgress();
+
+    if (_gameOptions.AISliceMs > 0) {
+        // no worker: the search advances a slice at a time from updateAI()
+        _aiSliced = true;
+        _aiSliceMicros = static_cast<int64_t>(_gameOptions.AISliceMs) * 1000;
+        _aiSlices = 0;
+        _aiSliceOverruns = 0;
+        _aiWorstOverrunMicros = 0;
+        _tt.newSearch();
+        _slicedSearch.start(_position, limits);
+        return;
+    }
+
+    _aiSliced = false;
+    launchAI(_position, limits);
+}
+
+void Chess::launchAI(const Position& root, const SearchLimits& limits)
+{
+    if (_search.threadCount() != _gameOptions.AIThreads) {
+        _search.setThreadCount(_gameOptions.AIThreads);
+    }
+
+    _aiDone.store(false, std::memory_order_relaxed);
+    // the worker searches its own copy, so the board can keep drawing from _position
+    _aiThread = std::thread([this, root, limits]() {
+        _aiResult = _search.think(root, limits);
+        AIProgress done;
+        done.finished = true;
+        while (!_aiProgress.push(done)) std::this_thread::yield();
+        _aiDone.store(true, std::memory_order_release);
+    });
+}
+
+//
+// Pondering: after the AI moves, the worker goes on searching the position after the reply
+// its PV expects, untimed, while the human thinks. If the human plays that reply the same
+// search carries on as the AI's next move with the usual time budget counted from then
+// (resolvePonder sets the ponder-hit flag); any other move abandons it.
+//
+void Chess::startPonder(const BitMove& predicted)
+{
+    MoveList moves;
+    generateLegalMoves(_position, moves);
+    if (std::find(moves.begin(), moves.end(), predicted) == moves.end()) return;
+
+    Position root = _position;
+    root.makeMove(predicted);
+    SearchLimits limits = aiLimits();
+    _ponderHit.store(false, std::memory_order_relaxed);
+    limits.ponderHit = &_ponderHit;
+
+    _aiThinking = true;
+    _aiPondering = true;
+    _ponderFinished = false;
+    _ponderMove = predicted;
+    _ponderStart = std::chrono::steady_clock::now();
+    _ponderSearches++;
+    _aiStatus = AIProgress();
+    launchAI(root, limits);
+}
+
+// The human has moved: keep the ponder (or matching speculative) search as the AI's move
+// on a hit, drop it otherwise
+void Chess::resolvePonder(const BitMove& played)
+{
+    if (_speculator.active()) {
+        _speculationHit = _speculator.select(played);
+        return;
+    }
+    if (!_aiPondering) return;
+
+    if (played == _ponderMove) {
+        _aiPondering = false;
+        _ponderHits++;
+        _ponderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - _ponderStart).count();
+        _ponderHit.store(true, std::memory_order_release);
+    } else {
+        stopAI();
+    }
+}
+
+// A speculative search for the human's actual reply: play its answer as soon as it is done
+void Chess::takeSpeculation()
+{
+    if (!_speculator.takeResult(_aiResult)) return;
+    _speculationHit = false;
+    finishAI();
+}
+
+// Time-sliced mode: one slice of search per frame, timed to see how well it keeps the budget
+void Chess::stepAI()
+{
+    const auto start = std::chrono::steady_clock::now();
+    const bool finished = _slicedSearch.step(_aiSliceMicros);
+    const int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    _aiSlices++;
+    if (micros > _aiSliceMicros) {
+        _aiSliceOverruns++;
+        _aiWorstOverrunMicros = std::max(_aiWorstOverrunMicros, micros - _aiSliceMicros);
+    }
+
+    AIProgress progress;
+    while (_aiProgress.pop(progress)) _aiStatus = progress;
+    if (finished) {
+        _aiResult = _slicedSearch.result();
+        finishAI();
+    }
+}
+
+// UI thread: the worker has queued its finished report (or the sliced search has
+// finished), so _aiResult is complete
+void Chess::finishAI()
+{
+    if (_aiThread.joinable()) _aiThread.join();
+    _aiThinking = false;
+
+    const SearchResult& result = _aiResult;
+    if (result.bestMove.isNull()) return; // mated or stalemated, EndOfTurn has already ended the game
+
+    std::string line;
+    for (const BitMove& m : result.pv) {
+        line += moveToUCI(m);
+        line += ' ';
+    }
+    std::cout << "AI depth " << result.depth << " score " << result.score << " nodes " << result.nodes
+              << " nps " << static_cast<uint64_t>(result.nps()) << " pawn hash " << static_cast<int>(100.0 * result.pawns.hitRate())
+              << "% time " << static_cast<int>(result.seconds * 1000.0) << "/" << result.hardLimitMs << " ms pv " << line << std::endl;
+    if (_aiSliced) {
+        std::cout << "  " << _aiSlices << " slices of " << _aiSliceMicros / 1000 << " ms, " << _aiSliceOverruns
+                  << " over budget, worst by " << _aiWorstOverrunMicros << " us" << std::endl;
+    }
+    if (result.threadNodes.size() > 1) {
+        for (size_t i = 0; i < result.threadNodes.size(); i++) {
+            std::cout << "  thread " << i << ": " << result.threadNodes[i] << " nodes" << std::endl;
+        }
+    }
+    if (_ponderSearches > 0) {
+        std::cout << "  " << ponderSummary() << std::endl;
+    }
+    if (_speculator.stats().rounds > 0) {
+        std::cout << "  " << speculationSummary() << std::endl;
+    }
+
+    playMove(result.bestMove);
+
+    // thinking on the human's time needs a human on the other side and worker threads;
+    // the ponder move is usually among the speculated replies, so speculation wins when both are on
+    if (_gameOptions.AIvsAI || _aiSliced) return;
+    if (_gameOptions.AISpeculate > 0) {
+        _speculator.start(_position, aiLimits(), _gameOptions.AISpeculate);
+    } else if (_gameOptions.AIPonder && result.pv.size() >= 2) {
+        startPonder(result.pv[1]);
+    }
+}
+
+// Abandon a search in progress (new game, game closed, human took over)
+void Chess::stopAI()
+{
+    _speculator.stop();
+    _speculationHit = false;
+
+    AIProgress discard;
+    if (_aiSliced) {
+        // nothing runs between slices; the next start() resets the search
+        while (_aiProgress.pop(discard)) { }
+        _aiSliced = false;
+        _aiThinking = false;
+        return;
+    }
+    if (!_aiThread.joinable()) return;
+
+    // think() clears the stop flag when it starts, so keep asking until the worker is done,
+    // draining the queue so its final push cannot block
+    while (!_aiDone.load(std::memory_order_acquire)) {
+        _search.stop();
+        while (_aiProgress.pop(discard)) { }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    _aiThread.join();
+    while (_aiProgress.pop(discard)) { }
+    _aiThinking = false;
+    _aiPondering = false;
+    _ponderFinished = false;
+}
+
+std::string Chess::aiStatus() const
+{
+    std::ostringstream out;
+    if (_aiThinking) {
+        if (_aiPondering) out << "AI pondering on " << moveToUCI(_ponderMove) << ": depth ";
+        else out << "AI thinking: depth ";
+        out << _aiStatus.depth << " score " << _aiStatus.score << " nodes " << _aiStatus.nodes
+            << " " << static_cast<int>(_aiStatus.seconds * 1000.0) << " ms pv";
+        for (int i = 0; i < _aiStatus.pvLength; i++) out << ' ' << moveToUCI(_aiStatus.pv[i]);
+        if (_aiSliced) {
+            out << " (" << _aiSlices << " slices, " << _aiSliceOverruns << " over, worst +" << _aiWorstOverrunMicros << " us)";
+        }
+    }
+    if (_speculator.active()) {
+        if (_speculationHit) {
+            out << "AI finishing its answer to " << moveToUCI(_speculator.selectedReply());
+        } else {
+            out << "AI speculating on " << _speculator.replyCount() << " replies:";
+            for (int i = 0; i < _speculator.replyCount(); i++) out << ' ' << moveToUCI(_speculator.reply(i));
+        }
+        out << " nodes " << _speculator.nodes();
+    }
+    if (_ponderSearches > 0) {
+        if (out.tellp() > 0) out << '\n';
+        out << ponderSummary();
+    }
+    if (_speculator.stats().rounds > 0) {
+        if (out.tellp() > 0) out << '\n';
+        out << speculationSummary();
+    }
+    return out.str();
+}
+
+std::string Chess::speculationSummary() const
+{
+    const SpeculationStats& stats = _speculator.stats();
+    std::ostringstream out;
+    out << "speculation hits " << stats.hits << "/" << stats.rounds << " (" << static_cast<int>(100.0 * stats.hitRate())
+        << "%), " << stats.immediate << " answered at once, mean reply latency on hits "
+        << static_cast<int>(stats.meanLatencyMs()) << " ms";
+    return out.str();
+}
+
+std::string Chess::ponderSummary() const
+{
+    // the search in progress is neither a hit nor a miss yet
+    const int decided = _ponderSearches - (_aiPondering ? 1 : 0);
+    std::ostringstream out;
+    out << "ponder hits " << _ponderHits << "/" << decided;
+    if (decided > 0) out << " (" << (100 * _ponderHits / decided) << "%)";
+    out << ", " << static_cast<int>(_ponderSeconds * 1000.0) << " ms thought on the human's time";
+    return out.str();
+}
+
+// The legal move for a from/to pair. Promotions from the board always pick the queen.
+BitMove Chess::findMove(int from, int to)
+{
+    MoveList moves;
+    generateAllMoves(_position, moves);
+    for (const BitMove& m : moves) {
+        if (m.from() == from && m.to() == to &&
+            (!m.isPromotion() || m.promotionPiece() == Queen)) {
+            return m;
+        }
+    }
+    return BitMove::none();
+}
+
+// Sprite side effects of the special moves. Call before the move is made on _position.
+void Chess::applySpecialMoveSprites(const BitMove& move)
+{
+    const int color = _position.sideToMove();
+
+    if (move.isCastle()) {
+        const bool kingSide = (move.to() & 7) == 6;
+        const int rookFrom = kingSide ? move.to() + 1 : move.to() - 2;
+        const int rookTo = kingSide ? move.to() - 1 : move.to() + 1;
+        ChessSquare* fromSq = _grid->getSquareByIndex(rookFrom);
+        ChessSquare* toSq = _grid->getSquareByIndex(rookTo);
+        Bit* rook = fromSq ? fromSq->bit() : nullptr;
+        if (rook && toSq) {
+            toSq->dropBitAtPoint(rook, toSq->getPosition());
+            fromSq->draggedBitTo(rook, toSq);
+        }
+    } else if (move.isEnPassant()) {
+        const int capturedSquare = move.to() + (color == White ? -8 : 8);
+        ChessSquare* capturedSq = _grid->getSquareByIndex(capturedSquare);
+        if (capturedSq && capturedSq->bit()) {
+            pieceTaken(capturedSq->bit());
+            capturedSq->destroyBit();
+        }
+    }
+
+    if (move.isPromotion()) {
+        ChessSquare* toSq = _grid->getSquareByIndex(move.to());
+        if (toSq) {
+            Bit* promoted = PieceForPlayer(color, move.promotionPiece());
+            promoted->setPosition(toSq->getPosition());
+            toSq->setBit(promoted);
+        }
+    }
 }
 
 bool Chess::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
@@ -499,17 +644,15 @@ bool Chess::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
     const int from = srcSq->getSquareIndex();
     const int to   = dstSq->getSquareIndex();
 
-    const char color = (getCurrentPlayer()->playerNumber() == 0) ? 'w' : 'b';
-
-    const std::string s = stateString();
-    std::vector<BitMove> moves = generateAllMoves(s.c_str(), color);
-
-    _lastMoves = moves;
-    _lastFrom = from;
+    // canBitMoveFrom already generated the list for this pick-up; only regenerate if needed
+    if (_lastFrom != from) {
+        generateAllMoves(_position, _lastMoves);
+        _lastFrom = from;
+    }
+    const MoveList& moves = _lastMoves;
 
-    const ChessPiece p = static_cast<ChessPiece>(bit.gameTag() & 0x7F);
     bool ok = std::any_of(moves.begin(), moves.end(), [&](const BitMove& m) {
-        return m.from == from && m.to == to && m.piece == static_cast<uint8_t>(p);
+        return m.from() == from && m.to() == to;
     });
 
     if (!ok) {
@@ -521,6 +664,7 @@ bool Chess::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
 
 void Chess::stopGame()
 {
+    stopAI();
     _grid->forEachSquare([](ChessSquare* square, int, int) {
         square->destroyBit();
     });
@@ -541,12 +685,29 @@ Player* Chess::ownerAt(int x, int y) const
 
 Player* Chess::checkForWinner()
 {
+    // checkmate: the side to move has no legal moves and is in check
+    MoveList moves;
+    generateAllMoves(_position, moves);
+    if (moves.empty() && inCheck(_position)) {
+        return getPlayerAt(_position.sideToMove() == White ? 1 : 0);
+    }
     return nullptr;
 }
 
 bool Chess::checkForDraw()
 {
-    return false;
+    // stalemate, fifty-move rule, threefold repetition or bare kings
+    MoveList moves;
+    generateAllMoves(_position, moves);
+    if (moves.empty()) return !inCheck(_position);
+    if (_position.halfmoveClock() >= 100) return true;
+    if (_position.repetitions() >= 2) return true;
+
+    // king and at most one minor piece against a bare king can never mate
+    const uint64_t heavy = _position.pieces(White, Pawn) | _position.pieces(Black, Pawn) |
+                           _position.pieces(White, Rook) | _position.pieces(Black, Rook) |
+                           _position.pieces(White, Queen) | _position.pieces(Black, Queen);
+    return heavy == 0 && popCount(_position.occupied()) <= 3;
 }
 
 std::string Chess::initialStateString()
@@ -561,6 +722,7 @@ std::string Chess::stateString()
 
     // State index is y*8+x, where y=0 is the BOTTOM row in this project.
     // This must match getSquare(x,y) and getSquareIndex().
+    // Read from the bitboard position, not the sprites.
     for (int y = 0; y < 8; y++) {
         for (int x = 0; x < 8; x++) {
             s += pieceNotation(x, y);
@@ -3,8 +3,19 @@
 #include "Game.h"
 #include "Grid.h"
 
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
 #include "Bitboard.h"
+#include "Position.h"
+#include "MoveList.h"
+#include "ReplySpeculator.h"
+#include "Search.h"
+#include "SpscQueue.h"
+#include "TranspositionTable.h"
 
 constexpr int pieceSize = 80;
 
@@ -33,20 +44,103 @@ public:
     void drawFrame() override;
     void clearBoardHighlights() override;
 
+    // AI: a move from the opening book (openingBook()) when _gameOptions.AIUseBook is set and
+    // the position is in it, otherwise an alpha-beta search within _gameOptions.AIMoveTimeMs, capped at
+    // _gameOptions.AIMAXDepth plies and an optional node budget in
+    // _gameOptions.AIDepthSearches (0 = none), on _gameOptions.AIThreads Lazy SMP threads.
+    // The search runs on a worker thread: the first updateAI() call of a turn starts it,
+    // later calls (one per frame) collect its progress and, once it is done, play the move
+    // on the calling (UI) thread. With _gameOptions.AISliceMs > 0 there is no worker: each
+    // updateAI() call searches single-threaded on the UI thread for at most that long.
+    // With _gameOptions.AIPonder the worker keeps searching the expected reply during the
+    // human's turn (see startPonder). _gameOptions.AISpeculate > 0 instead searches the
+    // answers to that many likely human replies at once (ReplySpeculator).
+    bool gameHasAI() override { return true; }
+    void updateAI() override;
+    // the search in progress and ponder statistics, empty when there is neither
+    std::string aiStatus() const;
+
     Grid* getGrid() override { return _grid; }
-    std::vector<BitMove> generateMoves(const char* state, char color);
-    std::vector<BitMove> generateAllMoves(const char* state, char color);
-    
+    void generateMoves(const Position& pos, MoveList& moves);
+    void generateAllMoves(const Position& pos, MoveList& moves);
+    const Position& position() const { return _position; }
+
 private:
     Bit* PieceForPlayer(const int playerNumber, ChessPiece piece);
     Player* ownerAt(int x, int y) const;
     void FENtoBoard(const std::string& fen);
     char pieceNotation(int x, int y) const;
+    BitMove findMove(int from, int to);
+    void applySpecialMoveSprites(const BitMove& move);
+    void playMove(const BitMove& move);
+    void commitMove(const BitMove& move);
+    SearchLimits aiLimits() const;
+    BitMove bookMove();
+    void startAI();
+    void launchAI(const Position& root, const SearchLimits& limits);
+    void startPonder(const BitMove& predicted);
+    void resolvePonder(const BitMove& played);
+    void takeSpeculation();
+    std::string ponderSummary() const;
+    std::string speculationSummary() const;
+    void stepAI();
+    void finishAI();
+    void stopAI();
 
     Grid* _grid;
+    Position _position;
 
-    std::vector<BitMove> _lastMoves;
+    MoveList _lastMoves;
     int _lastFrom = -1;
 
     bool _highlightsActive = false;
+
+    TranspositionTable _tt;
+    SearchThreads _search{ _tt };
+    // time-sliced mode, stepped from updateAI() on the UI thread
+    Search _slicedSearch{ _tt };
+
+    // what the AI worker reports after each iteration, and once more when it is done
+    struct AIProgress
+    {
+        bool finished = false;
+        int depth = 0;
+        int score = 0;
+        uint64_t nodes = 0;
+        double seconds = 0.0;
+        BitMove pv[12];
+        int pvLength = 0;
+    };
+
+    std::thread _aiThread;
+    // worker -> UI; iteration reports are dropped if the UI falls behind, the finished one never is
+    SpscQueue<AIProgress, 64> _aiProgress;
+    // written by the worker before it queues the finished report
+    SearchResult _aiResult;
+    std::atomic<bool> _aiDone{ false };
+    // UI thread only
+    bool _aiThinking = false;
+    bool _aiSliced = false;
+    int64_t _aiSliceMicros = 0;
+    int _aiSlices = 0;
+    int _aiSliceOverruns = 0;       // slices that ran past their budget
+    int64_t _aiWorstOverrunMicros = 0;
+    AIProgress _aiStatus;
+
+    // pondering: the worker searches the position after _ponderMove during the human's turn
+    std::atomic<bool> _ponderHit{ false };   // read by the search, see SearchLimits::ponderHit
+    bool _aiPondering = false;
+    bool _ponderFinished = false;             // the ponder search ended before the human moved
+    BitMove _ponderMove = BitMove::none();
+    std::chrono::steady_clock::time_point _ponderStart;
+    int _ponderSearches = 0;
+    int _ponderHits = 0;
+    double _ponderSeconds = 0.0;              // pondering time that turned into hits
+
+    // weighted book move selection
+    std::mt19937_64 _bookRandom{ std::random_device{}() };
+
+    // speculation: searches for the AI's answer to several human replies, one of them kept
+    ReplySpeculator _speculator{ _tt };
+    bool _speculationHit = false;             // the human played a speculated reply
 };
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Endgame.h"
+#include "Evaluate.h"
+#include <algorithm>
+#include <cstdlib>
+
+static inline int distance(int a, int b)
+{
+    return std::max(std::abs((a & 7) - (b & 7)), std::abs((a >> 3) - (b >> 3)));
+}
+
+// larger the closer the square is to an edge (and most in the corners)
+static inline int pushToEdge(int sq)
+{
+    const int file = sq & 7;
+    const int rank = sq >> 3;
+    return 20 * (6 - std::min(file, 7 - file) - std::min(rank, 7 - rank));
+}
+
+// larger the closer the two kings are
+static inline int pushClose(int a, int b)
+{
+    return 20 * (7 - distance(a, b));
+}
+
+static inline bool darkSquare(int sq)
+{
+    return (((sq & 7) + (sq >> 3)) & 1) == 0;
+}
+
+static int kingSquare(const Position& pos, int color)
+{
+    return bitScanForward(pos.pieces(color, King));
+}
+
+static int drawEndgame(const Position&, int)
+{
+    return 0;
+}
+
+// Drive the bare king to the edge and bring the attacking king up; a win when mate can be forced
+static int kxk(const Position& pos, int strongSide)
+{
+    const int strongKing = kingSquare(pos, strongSide);
+    const int weakKing = kingSquare(pos, strongSide ^ 1);
+
+    int score = pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+    for (int p = Pawn; p <= Queen; p++) {
+        score += PieceValue[p] * popCount(pos.pieces(strongSide, static_cast<ChessPiece>(p)));
+    }
+
+    const uint64_t bishops = pos.pieces(strongSide, Bishop);
+    const bool bothBishopColours = (bishops & 0xAA55AA55AA55AA55ULL) && (bishops & 0x55AA55AA55AA55AAULL);
+    if (pos.pieces(strongSide, Queen) || pos.pieces(strongSide, Rook) || bothBishopColours ||
+        (bishops && pos.pieces(strongSide, Knight))) {
+        score += KnownWin;
+    }
+    return score;
+}
+
+// Bishop and knight mate only happens in a corner of the bishop's colour
+static int kbnk(const Position& pos, int strongSide)
+{
+    const int strongKing = kingSquare(pos, strongSide);
+    const int weakKing = kingSquare(pos, strongSide ^ 1);
+    const bool dark = darkSquare(bitScanForward(pos.pieces(strongSide, Bishop)));
+
+    // a1/h8 are dark, a8/h1 light
+    const int cornerDistance = dark ? std::min(distance(weakKing, 0), distance(weakKing, 63))
+                                    : std::min(distance(weakKing, 56), distance(weakKing, 7));
+    return KnownWin + pushClose(strongKing, weakKing) + 40 * (7 - cornerDistance);
+}
+
+// Rook against pawn: usually a win unless the pawn is far advanced with its king in support
+// and the attacking king is cut off (the rules Stockfish uses).
+static int krkp(const Position& pos, int strongSide)
+{
+    // orient the board so the strong side is white and the pawn runs towards rank 1
+    const int flip = strongSide == White ? 0 : 56;
+    const int strongKing = kingSquare(pos, strongSide) ^ flip;
+    const int weakKing = kingSquare(pos, strongSide ^ 1) ^ flip;
+    const int rook = bitScanForward(pos.pieces(strongSide, Rook)) ^ flip;
+    const int pawn = bitScanForward(pos.pieces(strongSide ^ 1, Pawn)) ^ flip;
+    const int queening = pawn & 7;
+    const bool strongToMove = pos.sideToMove() == strongSide;
+
+    const int rookValue = PieceValue[Rook];
+    if ((strongKing & 7) == (pawn & 7) && strongKing < pawn) {
+        // the strong king stands in front of the pawn
+        return rookValue - distance(strongKing, pawn);
+    }
+    if (distance(weakKing, pawn) >= 3 + (strongToMove ? 0 : 1) && distance(weakKing, rook) >= 3) {
+        // the pawn is undefended and the rook can take it
+        return rookValue - distance(strongKing, pawn);
+    }
+    if ((weakKing >> 3) <= 2 && distance(weakKing, pawn) == 1 && (strongKing >> 3) >= 3 &&
+        distance(strongKing, pawn) > 2 + (strongToMove ? 1 : 0)) {
+        // the weak king is far up the board next to its pawn, and the strong king is cut off
+        return 80 - 8 * distance(strongKing, pawn);
+    }
+    return 200 - 8 * (distance(strongKing, pawn - 8) - distance(weakKing, pawn - 8) - distance(pawn, queening));
+}
+
+// Opposite-coloured bishops are notoriously drawish, more so without other pieces
+static int oppositeBishops(const Position& pos, int)
+{
+    const bool whiteDark = darkSquare(bitScanForward(pos.pieces(White, Bishop)));
+    const bool blackDark = darkSquare(bitScanForward(pos.pieces(Black, Bishop)));
+    if (whiteDark == blackDark) return ScaleNone;
+
+    const uint64_t others = pos.pieces(White, Knight) | pos.pieces(White, Rook) | pos.pieces(White, Queen) |
+                            pos.pieces(Black, Knight) | pos.pieces(Black, Rook) | pos.pieces(Black, Queen);
+    return others ? 46 : 22;
+}
+
+const EndgameFunction EndgameFunctions[] = { nullptr, drawEndgame, kxk, kbnk, krkp };
+const ScalingFunction ScalingFunctions[] = { nullptr, oppositeBishops };
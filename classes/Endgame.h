@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Material.h"
+#include "Position.h"
+
+// Scores a known endgame in centipawns for strongSide (the side MaterialEntry names)
+using EndgameFunction = int (*)(const Position& pos, int strongSide);
+// Scale factor (of ScaleNormal) for the endgame half of the score when strongSide is
+// ahead, or ScaleNone to keep the material table's static factor
+using ScalingFunction = int (*)(const Position& pos, int strongSide);
+
+constexpr int ScaleNone = 255;
+// well above any positional score, well below mate scores
+constexpr int KnownWin = 10000;
+
+// indexed by EndgameType / ScalingType; the "none" slots are null
+extern const EndgameFunction EndgameFunctions[];
+extern const ScalingFunction ScalingFunctions[];
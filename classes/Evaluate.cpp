@@ -0,0 +1,125 @@
+#include "Evaluate.h"
+#include "Bitboard.h"
+#include "Endgame.h"
+#include "Material.h"
+#include "PieceSquareTables.h"
+#include "Zobrist.h"
+
+#if defined(EVAL_DEBUG)
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+// Blend the middlegame and endgame sums by phase (white's point of view)
+static inline int taper(int mg, int eg, int phase)
+{
+    if (phase > MaxPhase) phase = MaxPhase; // early promotions can push it past the start count
+    return (mg * phase + eg * (MaxPhase - phase)) / MaxPhase;
+}
+
+// Cached pawn terms, plus the shield in front of each king while it is still on its back two ranks
+static inline void addPawnTerms(const Position& pos, const PawnEntry& entry, int& mg, int& eg)
+{
+    mg += entry.mg;
+    eg += entry.eg;
+    for (int color = White; color <= Black; color++) {
+        const uint64_t king = pos.pieces(color, King);
+        if (!king) continue;
+        const int sq = bitScanForward(king);
+        const int relativeRank = color == White ? sq / 8 : 7 - sq / 8;
+        if (relativeRank <= 1) mg += (color == White ? 1 : -1) * entry.shield[color][sq & 7];
+    }
+}
+
+// Known endgames are scored by their own function, from the side to move's point of view
+static inline int endgameScore(const Position& pos, const MaterialEntry& material)
+{
+    const int score = EndgameFunctions[material.endgame](pos, material.strongSide);
+    return pos.sideToMove() == material.strongSide ? score : -score;
+}
+
+// Add the material and pawn terms to the piece-square sums, scale the endgame half and taper
+static int blend(const Position& pos, const MaterialEntry& material, const PawnEntry& pawns, int mg, int eg, int phase)
+{
+    mg += material.imbalance;
+    eg += material.imbalance;
+    addPawnTerms(pos, pawns, mg, eg);
+
+    const int strongSide = eg >= 0 ? White : Black;
+    int factor = material.factor[strongSide];
+    if (material.scaling != NoScaling) {
+        const int scaled = ScalingFunctions[material.scaling](pos, strongSide);
+        if (scaled != ScaleNone) factor = scaled;
+    }
+    eg = eg * factor / ScaleNormal;
+
+    const int score = taper(mg, eg, phase);
+    return pos.sideToMove() == White ? score : -score;
+}
+
+int evaluateFromScratch(const Position& pos)
+{
+    int mg = 0;
+    int eg = 0;
+    int phase = 0;
+    int counts[2][7] = {};
+    for (int color = White; color <= Black; color++) {
+        for (int piece = Pawn; piece <= King; piece++) {
+            uint64_t bb = pos.pieces(color, static_cast<ChessPiece>(piece));
+            while (bb) {
+                const int sq = popLSB(bb);
+                const int index = color * 6 + piece - 1;
+                mg += PieceSquare.mg[index][sq];
+                eg += PieceSquare.eg[index][sq];
+                phase += PhaseWeight[piece];
+                counts[color][piece]++;
+            }
+        }
+    }
+
+    const MaterialEntry material = computeMaterial(counts);
+    if (material.endgame != NoEndgame) return endgameScore(pos, material);
+
+    PawnEntry pawns;
+    evaluatePawns(pos, pawns);
+    return blend(pos, material, pawns, mg, eg, phase);
+}
+
+#if defined(EVAL_DEBUG)
+static int checked(const Position& pos, int result)
+{
+    if (result != evaluateFromScratch(pos)) {
+        std::fprintf(stderr, "incremental eval %d != recomputed %d for %s\n", result, evaluateFromScratch(pos),
+                     pos.fen().c_str());
+        std::abort();
+    }
+    if (pos.pawnKey() != computePawnKey(pos)) {
+        std::fprintf(stderr, "incremental pawn key differs from recomputed for %s\n", pos.fen().c_str());
+        std::abort();
+    }
+    return result;
+}
+#else
+static inline int checked(const Position&, int result)
+{
+    return result;
+}
+#endif
+
+int evaluate(const Position& pos, PawnTable& pawns)
+{
+    // material, phase and piece-square terms come straight from the incrementally kept keys and sums
+    const MaterialEntry material = probeMaterial(pos);
+    if (material.endgame != NoEndgame) return checked(pos, endgameScore(pos, material));
+    return checked(pos, blend(pos, material, pawns.probe(pos), pos.psqMg(), pos.psqEg(), material.phase));
+}
+
+int evaluate(const Position& pos)
+{
+    const MaterialEntry material = probeMaterial(pos);
+    if (material.endgame != NoEndgame) return checked(pos, endgameScore(pos, material));
+
+    PawnEntry pawns;
+    evaluatePawns(pos, pawns);
+    return checked(pos, blend(pos, material, pawns, pos.psqMg(), pos.psqEg(), material.phase));
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "PawnTable.h"
+#include "Position.h"
+
+// Centipawn values indexed by ChessPiece (NoPiece, Pawn .. King); the king is never traded
+constexpr int PieceValue[7] = { 0, 100, 320, 330, 500, 900, 0 };
+
+// Static evaluation in centipawns from the side to move's point of view: tapered
+// material and piece-square terms, read from the sums Position updates in make/unmake,
+// plus pawn structure and king shield terms from the pawn cache. The material table
+// (Material.h) adds imbalance terms, scales drawish endgames and hands known endgames
+// to their own evaluators (Endgame.h).
+// Building with EVAL_DEBUG checks every call against evaluateFromScratch().
+int evaluate(const Position& pos, PawnTable& pawns);
+
+// the same without a cache: the pawn terms are computed on every call
+int evaluate(const Position& pos);
+
+// the same evaluation with every term recomputed from the bitboards
+int evaluateFromScratch(const Position& pos);
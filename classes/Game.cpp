@@ -3,6 +3,7 @@
 #include "BitHolder.h"
 #include "Turn.h"
 #include "../Application.h"
+#include <cmath>
 
 Game::Game()
 {
@@ -15,7 +16,15 @@ Game::Game()
 	_gameOptions.rowY = 0;
 	_gameOptions.score = 0;
 	_gameOptions.AIDepthSearches = 0;
+	_gameOptions.AIMAXDepth = 0;
 	_gameOptions.AIvsAI = false;
+	_gameOptions.AIThreads = 1;
+	_gameOptions.AIMoveTimeMs = 1000;
+	_gameOptions.AISliceMs = 0;
+	_gameOptions.AIPonder = false;
+	_gameOptions.AISpeculate = 0;
+	_gameOptions.AIUseBook = true;
+	_gameOptions.AIBookBest = false;
 
 	_table = nullptr;
 	_winner = nullptr;
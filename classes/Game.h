@@ -42,6 +42,13 @@ struct GameOptions
 	int AIDepthSearches;
 	int AIMAXDepth;
 	bool AIvsAI;
+	int AIThreads;
+	int AIMoveTimeMs;
+	int AISliceMs;
+	bool AIPonder;
+	int AISpeculate;
+	bool AIUseBook;
+	bool AIBookBest;
 };
 
 class Game
@@ -60,8 +60,8 @@ static inline uint64_t batt(int sq, uint64_t block) {
 }
 
 // Compiler-specific bit manipulation functions
-#ifdef __clang__
-    // Clang/LLVM specific bit counting
+#if defined(__clang__) || defined(__GNUC__)
+    // Clang/GCC builtin bit counting
     static inline int countOnes(uint64_t b) {
         return __builtin_popcountll(b);
     }
@@ -262,9 +262,9 @@ const int BAttackSize[64] = {
   64,
 };
 
-// Attack lookup tables
-static uint64_t* RAttacks[64];
-static uint64_t* BAttacks[64];
+// Attack lookup tables (inline so every translation unit shares one copy)
+inline uint64_t* RAttacks[64];
+inline uint64_t* BAttacks[64];
 
 // Magic bitboard shift amounts
 const int RShifts[64] = {
@@ -828,7 +828,7 @@ static inline uint64_t getQueenAttacks(int square, uint64_t occupied) {
 }
 
 // Initialize magic bitboards
-void initMagicBitboards(void) {
+inline void initMagicBitboards(void) {
     int square, i;
     uint64_t subset, index;
 
@@ -862,7 +862,7 @@ void initMagicBitboards(void) {
 }
 
 // Cleanup magic bitboard tables
-void cleanupMagicBitboards(void) {
+inline void cleanupMagicBitboards(void) {
     int square;
     for (square = 0; square < 64; square++) {
         delete[] RAttacks[square];
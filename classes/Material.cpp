@@ -0,0 +1,129 @@
+#include "Material.h"
+#include "Evaluate.h"
+#include "PieceSquareTables.h"
+#include <algorithm>
+#include <vector>
+
+static constexpr int BishopPairBonus = 40;
+// knights gain and rooks lose value per own pawn above five (Kaufman)
+static constexpr int KnightPawnAdjust = 6;
+static constexpr int RookPawnAdjust = 12;
+
+static int nonPawnMaterial(const int counts[7])
+{
+    return counts[Knight] * PieceValue[Knight] + counts[Bishop] * PieceValue[Bishop] +
+           counts[Rook] * PieceValue[Rook] + counts[Queen] * PieceValue[Queen];
+}
+
+static int sideImbalance(const int counts[7])
+{
+    int score = 0;
+    if (counts[Bishop] >= 2) score += BishopPairBonus;
+    score += counts[Knight] * KnightPawnAdjust * (counts[Pawn] - 5);
+    score -= counts[Rook] * RookPawnAdjust * (counts[Pawn] - 5);
+    return score;
+}
+
+// Scale for the endgame half when strong is ahead: without pawns a small material edge rarely wins
+static uint8_t staticFactor(const int strong[7], const int weak[7])
+{
+    const int strongMaterial = nonPawnMaterial(strong);
+    const int weakMaterial = nonPawnMaterial(weak);
+    if (strong[Pawn] == 0 && strongMaterial - weakMaterial <= PieceValue[Bishop]) {
+        if (strongMaterial < PieceValue[Rook]) return 0;
+        return weakMaterial <= PieceValue[Bishop] ? 4 : 14;
+    }
+    if (strong[Pawn] == 1 && strongMaterial - weakMaterial <= PieceValue[Bishop]) return 48;
+    return ScaleNormal;
+}
+
+static bool hasOnly(const int counts[7], ChessPiece piece, int count)
+{
+    for (int p = Pawn; p <= Queen; p++) {
+        if (counts[p] != (p == piece ? count : 0)) return false;
+    }
+    return true;
+}
+
+static bool bareKing(const int counts[7])
+{
+    return counts[Pawn] + counts[Knight] + counts[Bishop] + counts[Rook] + counts[Queen] == 0;
+}
+
+static bool cannotMate(const int counts[7])
+{
+    return bareKing(counts) || hasOnly(counts, Knight, 1) || hasOnly(counts, Bishop, 1) || hasOnly(counts, Knight, 2);
+}
+
+MaterialEntry computeMaterial(const int counts[2][7])
+{
+    MaterialEntry entry = {};
+    entry.imbalance = static_cast<int16_t>(sideImbalance(counts[White]) - sideImbalance(counts[Black]));
+
+    int phase = 0;
+    for (int p = Knight; p <= Queen; p++) phase += PhaseWeight[p] * (counts[White][p] + counts[Black][p]);
+    entry.phase = static_cast<uint8_t>(std::min(phase, 255));
+
+    entry.factor[White] = staticFactor(counts[White], counts[Black]);
+    entry.factor[Black] = staticFactor(counts[Black], counts[White]);
+
+    if (cannotMate(counts[White]) && cannotMate(counts[Black])) {
+        entry.endgame = EndgameDraw;
+        return entry;
+    }
+
+    for (int strong = White; strong <= Black; strong++) {
+        const int* us = counts[strong];
+        const int* them = counts[strong ^ 1];
+        if (bareKing(them) && us[Knight] == 1 && us[Bishop] == 1 && us[Pawn] + us[Rook] + us[Queen] == 0) {
+            entry.endgame = EndgameKBNK;
+            entry.strongSide = static_cast<uint8_t>(strong);
+            return entry;
+        }
+        if (bareKing(them) && nonPawnMaterial(us) >= PieceValue[Rook]) {
+            entry.endgame = EndgameKXK;
+            entry.strongSide = static_cast<uint8_t>(strong);
+            return entry;
+        }
+        if (hasOnly(us, Rook, 1) && hasOnly(them, Pawn, 1)) {
+            entry.endgame = EndgameKRKP;
+            entry.strongSide = static_cast<uint8_t>(strong);
+            return entry;
+        }
+    }
+
+    if (counts[White][Bishop] == 1 && counts[Black][Bishop] == 1) entry.scaling = ScaleOppositeBishops;
+    return entry;
+}
+
+static std::vector<MaterialEntry> buildMaterialTable()
+{
+    std::vector<MaterialEntry> table(MaterialTableSize);
+    for (uint32_t key = 0; key < MaterialTableSize; key++) {
+        int counts[2][7] = {};
+        for (int color = White; color <= Black; color++) {
+            uint32_t side = color == White ? key % MaterialSideSize : key / MaterialSideSize;
+            for (int p = Pawn; p <= Queen; p++) {
+                const uint32_t radix = MaterialMaxCount[p] + 1;
+                counts[color][p] = static_cast<int>(side % radix);
+                side /= radix;
+            }
+            counts[color][King] = 1;
+        }
+        table[key] = computeMaterial(counts);
+    }
+    return table;
+}
+
+MaterialEntry probeMaterial(const Position& pos)
+{
+    // built on first use; function-local statics are initialised once even with several search threads
+    static const std::vector<MaterialEntry> table = buildMaterialTable();
+    if (pos.materialKeyValid()) return table[pos.materialKey()];
+
+    int counts[2][7] = {};
+    for (int color = White; color <= Black; color++) {
+        for (int p = Pawn; p <= King; p++) counts[color][p] = popCount(pos.pieces(color, static_cast<ChessPiece>(p)));
+    }
+    return computeMaterial(counts);
+}
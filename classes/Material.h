@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include "Position.h"
+
+//
+// Material signature: the piece counts of both sides packed into one mixed-radix number,
+// which Position keeps up to date by adding or subtracting a stride per piece. Counts up
+// to the usual maxima (8 pawns, 2 knights/bishops/rooks, 1 queen per side) fit, which is
+// 486 signatures per side and 236196 in all. Extra promoted pieces would alias another
+// signature, so Position flags them and those positions are looked up the slow way.
+//
+constexpr int MaterialMaxCount[7] = { 0, 8, 2, 2, 2, 1, 1 };
+constexpr uint32_t MaterialSideSize = 9 * 3 * 3 * 3 * 2;
+constexpr uint32_t MaterialTableSize = MaterialSideSize * MaterialSideSize;
+// indexed like Position's bitboards: white pawn..king, black pawn..king (kings are always there)
+constexpr uint32_t MaterialStride[12] = {
+    1, 9, 27, 81, 243, 0,
+    MaterialSideSize, 9 * MaterialSideSize, 27 * MaterialSideSize, 81 * MaterialSideSize, 243 * MaterialSideSize, 0
+};
+
+// Specialised evaluators that replace the normal terms for known endgames
+enum EndgameType : uint8_t
+{
+    NoEndgame,
+    EndgameDraw,    // no mating material on either side: KK, KNK, KBK, KNNK
+    EndgameKXK,     // bare king against enough material to mate
+    EndgameKBNK,
+    EndgameKRKP
+};
+
+// Dynamic scaling of the endgame half of the score, for what the counts alone cannot tell
+enum ScalingType : uint8_t
+{
+    NoScaling,
+    ScaleOppositeBishops   // one bishop each, possibly on opposite colours
+};
+
+// Scale factors are out of ScaleNormal
+constexpr int ScaleNormal = 64;
+
+//
+// Everything the evaluation needs to know about a material signature, precomputed for
+// every signature at startup so a node pays one table load instead of branching on
+// piece counts.
+//
+struct MaterialEntry
+{
+    int16_t imbalance;     // white minus black, added to both game phases
+    uint8_t phase;         // 24 = all pieces, 0 = pawns and kings only
+    uint8_t endgame;       // EndgameType
+    uint8_t strongSide;    // the side the endgame function scores for
+    uint8_t scaling;       // ScalingType
+    uint8_t factor[2];     // static endgame scale when that colour is ahead
+};
+
+// the entry for pos's material: a table load, or computed when promotions overflow the table
+MaterialEntry probeMaterial(const Position& pos);
+
+// the entry computed from piece counts, without the table
+MaterialEntry computeMaterial(const int counts[2][7]);
@@ -0,0 +1,318 @@
+#include "MoveGen.h"
+#include "MagicBitboards.h"
+#include <mutex>
+
+static const uint64_t kNotAFile = 0xfefefefefefefefeULL;
+static const uint64_t kNotHFile = 0x7f7f7f7f7f7f7f7fULL;
+
+// Pawn attacks and square-pair rays, built by initMoveGenTables()
+static uint64_t PAWN_ATK[2][64];
+static uint64_t BETWEEN[64][64];   // squares strictly between two aligned squares
+static uint64_t LINE[64][64];      // the full line through two aligned squares, 0 if not aligned
+
+static void initRayTables()
+{
+    for (int sq = 0; sq < 64; sq++) {
+        const uint64_t b = 1ULL << sq;
+        PAWN_ATK[White][sq] = ((b & kNotAFile) << 7) | ((b & kNotHFile) << 9);
+        PAWN_ATK[Black][sq] = ((b & kNotAFile) >> 9) | ((b & kNotHFile) >> 7);
+    }
+
+    for (int a = 0; a < 64; a++) {
+        for (int b = 0; b < 64; b++) {
+            BETWEEN[a][b] = 0ULL;
+            LINE[a][b] = 0ULL;
+            if (a == b) continue;
+
+            const uint64_t bitA = 1ULL << a;
+            const uint64_t bitB = 1ULL << b;
+            if (getRookAttacks(a, 0ULL) & bitB) {
+                BETWEEN[a][b] = getRookAttacks(a, bitB) & getRookAttacks(b, bitA);
+                LINE[a][b] = (getRookAttacks(a, 0ULL) & getRookAttacks(b, 0ULL)) | bitA | bitB;
+            } else if (getBishopAttacks(a, 0ULL) & bitB) {
+                BETWEEN[a][b] = getBishopAttacks(a, bitB) & getBishopAttacks(b, bitA);
+                LINE[a][b] = (getBishopAttacks(a, 0ULL) & getBishopAttacks(b, 0ULL)) | bitA | bitB;
+            }
+        }
+    }
+}
+
+void initMoveGenTables()
+{
+    static std::once_flag once;
+    std::call_once(once, [] {
+        initMagicBitboards();
+        initRayTables();
+    });
+}
+
+uint64_t pawnAttacks(int color, int square) { return PAWN_ATK[color][square]; }
+uint64_t betweenBB(int a, int b) { return BETWEEN[a][b]; }
+uint64_t lineBB(int a, int b) { return LINE[a][b]; }
+
+uint64_t attackersTo(const Position& pos, int square, uint64_t occupied)
+{
+    const uint64_t rooksQueens = pos.pieces(White, Rook) | pos.pieces(White, Queen) |
+                                 pos.pieces(Black, Rook) | pos.pieces(Black, Queen);
+    const uint64_t bishopsQueens = pos.pieces(White, Bishop) | pos.pieces(White, Queen) |
+                                   pos.pieces(Black, Bishop) | pos.pieces(Black, Queen);
+
+    return (PAWN_ATK[Black][square] & pos.pieces(White, Pawn)) |
+           (PAWN_ATK[White][square] & pos.pieces(Black, Pawn)) |
+           (KnightAttacks[square] & (pos.pieces(White, Knight) | pos.pieces(Black, Knight))) |
+           (KingAttacks[square] & (pos.pieces(White, King) | pos.pieces(Black, King))) |
+           (getRookAttacks(square, occupied) & rooksQueens) |
+           (getBishopAttacks(square, occupied) & bishopsQueens);
+}
+
+bool isSquareAttacked(const Position& pos, int square, int byColor)
+{
+    return (attackersTo(pos, square, pos.occupied()) & pos.occupancy(byColor)) != 0;
+}
+
+bool inCheck(const Position& pos)
+{
+    const uint64_t king = pos.pieces(pos.sideToMove(), King);
+    return king && isSquareAttacked(pos, bitScanForward(king), pos.sideToMove() ^ 1);
+}
+
+static inline void addMoves(MoveList& moves, int from, uint64_t targets, uint64_t enemy)
+{
+    while (targets) {
+        const int to = popLSB(targets);
+        moves.emplace_back(from, to, (enemy & (1ULL << to)) ? CaptureMove : QuietMove);
+    }
+}
+
+// Pawn move onto the last rank expands into the four promotions (queen first)
+static inline void addPawnMove(MoveList& moves, int from, int to, bool capture)
+{
+    if (to >= 56 || to < 8) {
+        const int base = capture ? KnightPromoCapture : KnightPromotion;
+        for (int i = 3; i >= 0; i--) {
+            moves.emplace_back(from, to, static_cast<MoveFlag>(base + i));
+        }
+    } else {
+        moves.emplace_back(from, to, capture ? CaptureMove : QuietMove);
+    }
+}
+
+//
+// Everything that decides legality is computed once per position:
+//   checkers - enemy pieces giving check
+//   pinned   - our pieces that are the only blocker between our king and an enemy slider (found by x-ray)
+//   target   - squares a non-king move may land on (block/capture the checker when in check)
+// Pinned pieces may only move along the line through the king and the pinner.
+// King moves are tested against enemy attacks with the king removed from the occupancy.
+// The pseudo-legal generator uses the same code with no pins and no king filtering.
+//
+struct MoveGenContext
+{
+    int us;
+    int them;
+    int kingSquare;
+    uint64_t friendly;
+    uint64_t enemy;
+    uint64_t occupied;
+    uint64_t checkers;
+    uint64_t pinned;
+    bool legal;
+};
+
+static inline uint64_t pinMask(const MoveGenContext& ctx, int from)
+{
+    return (ctx.pinned & (1ULL << from)) ? LINE[ctx.kingSquare][from] : ~0ULL;
+}
+
+static void generateKingMoves(const Position& pos, const MoveGenContext& ctx, MoveList& moves)
+{
+    const uint64_t occupiedNoKing = ctx.occupied ^ (1ULL << ctx.kingSquare);
+    uint64_t targets = KingAttacks[ctx.kingSquare] & ~ctx.friendly;
+    while (targets) {
+        const int to = popLSB(targets);
+        if (ctx.legal && (attackersTo(pos, to, occupiedNoKing) & ctx.enemy)) continue;
+        moves.emplace_back(ctx.kingSquare, to, (ctx.enemy & (1ULL << to)) ? CaptureMove : QuietMove);
+    }
+}
+
+// Castling: rights still held, rook at home, nothing in between, not in check and
+// the king does not pass through or land on an attacked square.
+static void generateCastling(const Position& pos, const MoveGenContext& ctx, MoveList& moves)
+{
+    if (ctx.checkers) return;
+
+    const uint8_t rights = pos.castlingRights();
+    const int home = (ctx.us == White) ? 4 : 60;
+    if (ctx.kingSquare != home) return;
+
+    const uint8_t kingSide = (ctx.us == White) ? WhiteKingSide : BlackKingSide;
+    const uint8_t queenSide = (ctx.us == White) ? WhiteQueenSide : BlackQueenSide;
+    const uint64_t rooks = pos.pieces(ctx.us, Rook);
+    const uint64_t occupiedNoKing = ctx.occupied ^ (1ULL << home);
+
+    auto safe = [&](int square) {
+        return !(attackersTo(pos, square, occupiedNoKing) & ctx.enemy);
+    };
+
+    if ((rights & kingSide) && (rooks & (1ULL << (home + 3))) &&
+        !(BETWEEN[home][home + 3] & ctx.occupied) && safe(home + 1) && safe(home + 2)) {
+        moves.emplace_back(home, home + 2, KingCastle);
+    }
+    if ((rights & queenSide) && (rooks & (1ULL << (home - 4))) &&
+        !(BETWEEN[home][home - 4] & ctx.occupied) && safe(home - 1) && safe(home - 2)) {
+        moves.emplace_back(home, home - 2, QueenCastle);
+    }
+}
+
+// En passant is checked against the position after the capture, which covers the
+// rare case of both pawns leaving a rank shared by our king and an enemy rook.
+static void generateEnPassant(const Position& pos, const MoveGenContext& ctx, MoveList& moves)
+{
+    const int ep = pos.epSquare();
+    if (ep == NoSquare) return;
+
+    const int capturedSquare = ep + (ctx.us == White ? -8 : 8);
+    uint64_t attackers = PAWN_ATK[ctx.them][ep] & pos.pieces(ctx.us, Pawn);
+    while (attackers) {
+        const int from = popLSB(attackers);
+        if (ctx.legal) {
+            const uint64_t capturedBit = 1ULL << capturedSquare;
+            const uint64_t occupiedAfter = (ctx.occupied ^ (1ULL << from) ^ capturedBit) | (1ULL << ep);
+            if (attackersTo(pos, ctx.kingSquare, occupiedAfter) & ctx.enemy & ~capturedBit) continue;
+        }
+        moves.emplace_back(from, ep, EnPassantCapture);
+    }
+}
+
+static inline void addPawnMoves(MoveList& moves, const MoveGenContext& ctx, uint64_t targets, int offset, MoveFlag flag)
+{
+    while (targets) {
+        const int to = popLSB(targets);
+        const int from = to - offset;
+        if ((ctx.pinned & (1ULL << from)) && !(LINE[ctx.kingSquare][from] & (1ULL << to))) continue;
+        if (flag == DoublePawnPush) {
+            moves.emplace_back(from, to, DoublePawnPush);
+        } else {
+            addPawnMove(moves, from, to, flag == CaptureMove);
+        }
+    }
+}
+
+// All non-king moves that land on target (the full board when not in check, block/capture squares in check)
+static void generatePieceMoves(const Position& pos, const MoveGenContext& ctx, uint64_t target, MoveList& moves)
+{
+    const uint64_t empty = ~ctx.occupied;
+
+    // PAWNS (y=0 is the bottom: white moves toward higher y, black toward lower y)
+    const uint64_t pawns = pos.pieces(ctx.us, Pawn);
+    const int forward = (ctx.us == White) ? 8 : -8;
+    uint64_t single, doubled, capLeft, capRight;
+    if (ctx.us == White) {
+        single   = (pawns << 8) & empty;
+        doubled  = ((single & 0x0000000000FF0000ULL) << 8) & empty;
+        capLeft  = ((pawns & kNotAFile) << 7) & ctx.enemy;
+        capRight = ((pawns & kNotHFile) << 9) & ctx.enemy;
+    } else {
+        single   = (pawns >> 8) & empty;
+        doubled  = ((single & 0x0000FF0000000000ULL) >> 8) & empty;
+        capLeft  = ((pawns & kNotAFile) >> 9) & ctx.enemy;
+        capRight = ((pawns & kNotHFile) >> 7) & ctx.enemy;
+    }
+    addPawnMoves(moves, ctx, single & target, forward, QuietMove);
+    addPawnMoves(moves, ctx, doubled & target, 2 * forward, DoublePawnPush);
+    addPawnMoves(moves, ctx, capLeft & target, forward - 1, CaptureMove);
+    addPawnMoves(moves, ctx, capRight & target, forward + 1, CaptureMove);
+
+    // KNIGHTS (a pinned knight can never move)
+    uint64_t knights = pos.pieces(ctx.us, Knight) & ~ctx.pinned;
+    while (knights) {
+        const int from = popLSB(knights);
+        addMoves(moves, from, KnightAttacks[from] & target, ctx.enemy);
+    }
+
+    // SLIDERS: magic lookups give the attack set, friendly pieces are masked off by target
+    uint64_t bishops = pos.pieces(ctx.us, Bishop);
+    while (bishops) {
+        const int from = popLSB(bishops);
+        addMoves(moves, from, getBishopAttacks(from, ctx.occupied) & target & pinMask(ctx, from), ctx.enemy);
+    }
+
+    uint64_t rooks = pos.pieces(ctx.us, Rook);
+    while (rooks) {
+        const int from = popLSB(rooks);
+        addMoves(moves, from, getRookAttacks(from, ctx.occupied) & target & pinMask(ctx, from), ctx.enemy);
+    }
+
+    uint64_t queens = pos.pieces(ctx.us, Queen);
+    while (queens) {
+        const int from = popLSB(queens);
+        addMoves(moves, from, getQueenAttacks(from, ctx.occupied) & target & pinMask(ctx, from), ctx.enemy);
+    }
+}
+
+static void initContext(const Position& pos, MoveGenContext& ctx, bool legal)
+{
+    ctx.us = pos.sideToMove();
+    ctx.them = ctx.us ^ 1;
+    ctx.friendly = pos.occupancy(ctx.us);
+    ctx.enemy = pos.occupancy(ctx.them);
+    ctx.occupied = pos.occupied();
+    ctx.pinned = 0ULL;
+    ctx.legal = legal;
+
+    const uint64_t king = pos.pieces(ctx.us, King);
+    ctx.kingSquare = king ? bitScanForward(king) : NoSquare;
+    ctx.checkers = king ? (attackersTo(pos, ctx.kingSquare, ctx.occupied) & ctx.enemy) : 0ULL;
+}
+
+void generatePseudoLegalMoves(const Position& pos, MoveList& moves)
+{
+    MoveGenContext ctx;
+    initContext(pos, ctx, false);
+
+    generatePieceMoves(pos, ctx, ~ctx.friendly, moves);
+    generateEnPassant(pos, ctx, moves);
+    if (ctx.kingSquare != NoSquare) {
+        generateKingMoves(pos, ctx, moves);
+        generateCastling(pos, ctx, moves);
+    }
+}
+
+void generateLegalMoves(const Position& pos, MoveList& moves)
+{
+    MoveGenContext ctx;
+    initContext(pos, ctx, true);
+
+    if (ctx.kingSquare == NoSquare) {
+        // no king (test positions): nothing can be in check, fall back to pseudo-legal
+        generatePseudoLegalMoves(pos, moves);
+        return;
+    }
+
+    // x-ray from the king through our own pieces to find pinned pieces
+    uint64_t snipers = (getRookAttacks(ctx.kingSquare, 0ULL) & (pos.pieces(ctx.them, Rook) | pos.pieces(ctx.them, Queen))) |
+                       (getBishopAttacks(ctx.kingSquare, 0ULL) & (pos.pieces(ctx.them, Bishop) | pos.pieces(ctx.them, Queen)));
+    while (snipers) {
+        const int sniper = popLSB(snipers);
+        const uint64_t blockers = BETWEEN[ctx.kingSquare][sniper] & ctx.occupied;
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & ctx.friendly)) {
+            ctx.pinned |= blockers;
+        }
+    }
+
+    generateKingMoves(pos, ctx, moves);
+
+    // double check: only the king can move
+    if (ctx.checkers & (ctx.checkers - 1)) return;
+
+    if (ctx.checkers) {
+        // single check evasion: capture the checker or block the ray to the king
+        const int checker = bitScanForward(ctx.checkers);
+        generatePieceMoves(pos, ctx, ctx.checkers | BETWEEN[ctx.kingSquare][checker], moves);
+        generateEnPassant(pos, ctx, moves);
+    } else {
+        generatePieceMoves(pos, ctx, ~ctx.friendly, moves);
+        generateEnPassant(pos, ctx, moves);
+        generateCastling(pos, ctx, moves);
+    }
+}
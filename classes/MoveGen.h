@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Bitboard.h"
+#include "MoveList.h"
+#include "Position.h"
+
+// Builds the magic bitboard attack tables. Safe to call more than once; must run before any generation.
+void initMoveGenTables();
+
+// Pseudo-legal moves for the side to move. Moves that leave the king in check are included.
+void generatePseudoLegalMoves(const Position& pos, MoveList& moves);
+
+// Fully legal moves for the side to move: pins, checks and double checks are resolved
+// up front, so no move needs to be made and tested.
+void generateLegalMoves(const Position& pos, MoveList& moves);
+
+// Attack queries
+uint64_t attackersTo(const Position& pos, int square, uint64_t occupied); // both colours
+bool isSquareAttacked(const Position& pos, int square, int byColor);
+bool inCheck(const Position& pos);
+
+// Precomputed tables
+uint64_t pawnAttacks(int color, int square);
+uint64_t betweenBB(int a, int b);   // squares strictly between a and b, 0 if not on a line
+uint64_t lineBB(int a, int b);      // whole line through a and b, 0 if not on a line
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include "Bitboard.h"
+
+//
+// Fixed-capacity move list meant to live on the stack, so move generation,
+// search and perft never allocate. 256 is above the maximum number of legal
+// moves in any chess position (218).
+//
+// Each move has an optional score slot for move ordering; the scores are only
+// written when a caller uses them.
+//
+class MoveList
+{
+public:
+    static constexpr int Capacity = 256;
+
+    MoveList() : _size(0) { }
+
+    void push_back(const BitMove& move) { _moves[_size++] = move; }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) { _moves[_size++] = BitMove(args...); }
+
+    void clear() { _size = 0; }
+    int size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    BitMove& operator[](int index) { return _moves[index]; }
+    const BitMove& operator[](int index) const { return _moves[index]; }
+
+    BitMove* begin() { return _moves; }
+    BitMove* end() { return _moves + _size; }
+    const BitMove* begin() const { return _moves; }
+    const BitMove* end() const { return _moves + _size; }
+
+    int score(int index) const { return _scores[index]; }
+    void setScore(int index, int score) { _scores[index] = score; }
+
+    // swaps two moves together with their scores (partial selection sorts in place)
+    void swap(int a, int b) {
+        const BitMove move = _moves[a];
+        _moves[a] = _moves[b];
+        _moves[b] = move;
+        const int score = _scores[a];
+        _scores[a] = _scores[b];
+        _scores[b] = score;
+    }
+
+    bool contains(const BitMove& move) const {
+        for (int i = 0; i < _size; i++) {
+            if (_moves[i] == move) return true;
+        }
+        return false;
+    }
+
+private:
+    BitMove _moves[Capacity];
+    int _scores[Capacity];
+    int _size;
+};
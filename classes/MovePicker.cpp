@@ -0,0 +1,189 @@
+#include "MovePicker.h"
+#include "Evaluate.h"
+#include "MoveGen.h"
+#include "StaticExchange.h"
+#include <cstring>
+
+void SearchHistory::clear()
+{
+    for (auto& plyKillers : killers) {
+        plyKillers[0] = BitMove::none();
+        plyKillers[1] = BitMove::none();
+    }
+    for (auto& piece : counterMoves) {
+        for (BitMove& move : piece) move = BitMove::none();
+    }
+    std::memset(butterfly, 0, sizeof(butterfly));
+    std::memset(continuation, 0, sizeof(continuation));
+}
+
+void SearchHistory::age()
+{
+    // killers belong to the previous search's plies, which no longer line up
+    for (auto& plyKillers : killers) {
+        plyKillers[0] = BitMove::none();
+        plyKillers[1] = BitMove::none();
+    }
+    for (auto& side : butterfly) {
+        for (auto& from : side) {
+            for (int16_t& entry : from) entry /= 2;
+        }
+    }
+    for (auto& prevPiece : continuation) {
+        for (auto& prevTo : prevPiece) {
+            for (auto& piece : prevTo) {
+                for (int16_t& entry : piece) entry /= 2;
+            }
+        }
+    }
+}
+
+MovePicker::MovePicker(const Position& pos, BitMove hashMove, const SearchHistory& history, int ply, Mode mode)
+    : _pos(pos), _history(history), _ply(ply), _mode(mode), _hashMove(hashMove)
+{
+    generateLegalMoves(pos, _moves);
+
+    // captures and promotions to the front
+    for (int i = 0; i < _moves.size(); i++) {
+        if (_moves[i].isCapture() || _moves[i].isPromotion()) {
+            _moves.swap(i, _quietStart++);
+        }
+    }
+
+    if (!_moves.contains(_hashMove)) _hashMove = BitMove::none();
+    if (mode == Quiescence && !_hashMove.isNull() && !_hashMove.isCapture() &&
+        !(_hashMove.isPromotion() && _hashMove.promotionPiece() == Queen)) {
+        _hashMove = BitMove::none();
+    }
+
+    const int killerPly = ply < HistoryMaxPly ? ply : HistoryMaxPly - 1;
+    _killers[0] = history.killers[killerPly][0];
+    _killers[1] = history.killers[killerPly][1];
+    _counterMove = BitMove::none();
+
+    const BitMove prev = pos.lastMove();
+    if (!prev.isNull()) {
+        _prevPiece = SearchHistory::pieceIndex(pos.pieceAt(prev.to()));
+        _prevTo = prev.to();
+        _counterMove = history.counterMoves[_prevPiece][_prevTo];
+    }
+}
+
+bool MovePicker::isQuietInList(const BitMove& move) const
+{
+    if (move.isNull()) return false;
+    for (int i = _quietStart; i < _moves.size(); i++) {
+        if (_moves[i] == move) return true;
+    }
+    return false;
+}
+
+// moves already handed out by an earlier stage
+bool MovePicker::isSpecial(const BitMove& move) const
+{
+    return move == _hashMove || move == _killers[0] || move == _killers[1] || move == _counterMove;
+}
+
+// partial selection: swap the best scored move in [_current, end) to _current
+BitMove MovePicker::pickBest(int end)
+{
+    int best = _current;
+    for (int i = _current + 1; i < end; i++) {
+        if (_moves.score(i) > _moves.score(best)) best = i;
+    }
+    _moves.swap(_current, best);
+    return _moves[_current++];
+}
+
+BitMove MovePicker::next()
+{
+    switch (_stage) {
+    case StageHashMove:
+        _stage = StageScoreCaptures;
+        if (!_hashMove.isNull()) return _hashMove;
+        [[fallthrough]];
+
+    case StageScoreCaptures:
+        // MVV-LVA: victim value dominates, the attacker breaks ties; promotions count the new piece
+        for (int i = 0; i < _quietStart; i++) {
+            const BitMove move = _moves[i];
+            const int victim = move.isEnPassant() ? Pawn : pieceTypeOf(_pos.pieceAt(move.to()));
+            const int attacker = pieceTypeOf(_pos.pieceAt(move.from()));
+            int score = PieceValue[victim] * 16 - attacker;
+            if (move.isPromotion()) score += PieceValue[move.promotionPiece()] * 16;
+            _moves.setScore(i, score);
+        }
+        _current = 0;
+        _stage = StageCaptures;
+        [[fallthrough]];
+
+    case StageCaptures:
+        while (_current < _quietStart) {
+            const BitMove move = pickBest(_quietStart);
+            if (move == _hashMove) continue;
+            if (_mode == Quiescence && move.isPromotion() && move.promotionPiece() != Queen) continue;
+            if (!see(_pos, move, 0)) {
+                if (_mode == MainSearch) _badCaptures[_badCount++] = move;
+                continue;
+            }
+            return move;
+        }
+        if (_mode == Quiescence) {
+            _stage = StageDone;
+            return BitMove::none();
+        }
+        _stage = StageKiller1;
+        [[fallthrough]];
+
+    case StageKiller1:
+        _stage = StageKiller2;
+        if (_killers[0] != _hashMove && isQuietInList(_killers[0])) return _killers[0];
+        [[fallthrough]];
+
+    case StageKiller2:
+        _stage = StageCounterMove;
+        if (_killers[1] != _hashMove && _killers[1] != _killers[0] && isQuietInList(_killers[1])) return _killers[1];
+        [[fallthrough]];
+
+    case StageCounterMove:
+        _stage = StageScoreQuiets;
+        if (_counterMove != _hashMove && _counterMove != _killers[0] && _counterMove != _killers[1] &&
+            isQuietInList(_counterMove)) {
+            return _counterMove;
+        }
+        [[fallthrough]];
+
+    case StageScoreQuiets: {
+        const int side = _pos.sideToMove();
+        for (int i = _quietStart; i < _moves.size(); i++) {
+            const BitMove move = _moves[i];
+            int score = _history.butterfly[side][move.from()][move.to()];
+            if (_prevPiece >= 0) {
+                const int piece = SearchHistory::pieceIndex(_pos.pieceAt(move.from()));
+                score += _history.continuation[_prevPiece][_prevTo][piece][move.to()];
+            }
+            _moves.setScore(i, score);
+        }
+        _current = _quietStart;
+        _stage = StageQuiets;
+        [[fallthrough]];
+    }
+
+    case StageQuiets:
+        while (_current < _moves.size()) {
+            const BitMove move = pickBest(_moves.size());
+            if (!isSpecial(move)) return move;
+        }
+        _stage = StageBadCaptures;
+        [[fallthrough]];
+
+    case StageBadCaptures:
+        // still in MVV-LVA order from the capture stage
+        if (_badCurrent < _badCount) return _badCaptures[_badCurrent++];
+        _stage = StageDone;
+        [[fallthrough]];
+
+    default:
+        return BitMove::none();
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include "Bitboard.h"
+#include "MoveList.h"
+#include "Position.h"
+
+constexpr int HistoryMaxPly = 128;
+// history scores stay within +-HistoryLimit (gravity update)
+constexpr int HistoryLimit = 16384;
+
+//
+// Per-thread move ordering memory, filled in by the search on beta cutoffs:
+//   killers       two quiet moves per ply that caused a cutoff at that ply
+//   counterMoves  the quiet refutation of the opponent's last move (piece, to)
+//   butterfly     [side][from][to] success of quiet moves
+//   continuation  [previous piece][previous to][piece][to] success of a quiet move as
+//                 a reply to the opponent's last move
+// The tables are cache-line aligned and halved between searches (age()) so old
+// results fade instead of being wiped.
+//
+struct alignas(64) SearchHistory
+{
+    BitMove killers[HistoryMaxPly][2];
+    BitMove counterMoves[12][64];
+    int16_t butterfly[2][64][64];
+    int16_t continuation[12][64][12][64];
+
+    SearchHistory() { clear(); }
+
+    void clear();
+    void age();
+
+    // gravity: pulls the entry toward +-HistoryLimit, slower the closer it already is
+    static void update(int16_t& entry, int bonus) {
+        const int clamped = bonus > HistoryLimit ? HistoryLimit : (bonus < -HistoryLimit ? -HistoryLimit : bonus);
+        entry = static_cast<int16_t>(entry + clamped - entry * (clamped < 0 ? -clamped : clamped) / HistoryLimit);
+    }
+
+    // index of a piece code (Position::pieceAt) into the 12 piece slots
+    static int pieceIndex(uint8_t code) { return pieceColorOf(code) * 6 + pieceTypeOf(code) - 1; }
+};
+
+//
+// Hands out the legal moves of a position one at a time, best guess first:
+//   1. hash move
+//   2. winning and equal captures/promotions (SEE >= 0), most valuable victim /
+//      least valuable attacker first
+//   3. killer moves for this ply
+//   4. countermove to the opponent's last move
+//   5. remaining quiets by butterfly + continuation history
+//   6. losing captures, deferred from stage 2
+// Each stage is scored only when reached and then picked by partial selection (one
+// pass for the best remaining move per call), so a cutoff on the hash move or an
+// early capture never pays for scoring or sorting the quiets.
+//
+// Quiescence mode only yields captures and queen promotions and drops the losing
+// captures instead of deferring them.
+//
+class MovePicker
+{
+public:
+    enum Mode
+    {
+        MainSearch,
+        Quiescence
+    };
+
+    MovePicker(const Position& pos, BitMove hashMove, const SearchHistory& history, int ply, Mode mode = MainSearch);
+
+    // next move, or BitMove::none() when exhausted
+    BitMove next();
+
+    // number of legal moves (0 = mate or stalemate)
+    int legalCount() const { return _moves.size(); }
+
+private:
+    enum Stage
+    {
+        StageHashMove,
+        StageScoreCaptures,
+        StageCaptures,
+        StageKiller1,
+        StageKiller2,
+        StageCounterMove,
+        StageScoreQuiets,
+        StageQuiets,
+        StageBadCaptures,
+        StageDone
+    };
+
+    bool isQuietInList(const BitMove& move) const;
+    bool isSpecial(const BitMove& move) const;
+    BitMove pickBest(int end);
+
+    const Position& _pos;
+    const SearchHistory& _history;
+    MoveList _moves;        // captures/promotions first, quiets after
+    int _quietStart = 0;
+    int _current = 0;
+    int _stage = StageHashMove;
+    int _ply;
+    Mode _mode;
+
+    BitMove _badCaptures[MoveList::Capacity];
+    int _badCount = 0;
+    int _badCurrent = 0;
+
+    BitMove _hashMove;
+    BitMove _killers[2];
+    BitMove _counterMove;
+    // opponent's last move (for countermove/continuation), piece slot -1 when none
+    int _prevPiece = -1;
+    int _prevTo = 0;
+};
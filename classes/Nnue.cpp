@@ -0,0 +1,371 @@
+#include "Nnue.h"
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define NNUE_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+static const char NnueMagic[8] = { 'C', 'H', 'E', 'S', 'S', 'N', 'N', '1' };
+static constexpr size_t NnueHeaderSize = 64;
+static constexpr size_t NnueBodyValues = NnueHidden + static_cast<size_t>(NnueInputs) * NnueHidden + 2 * NnueHidden;
+
+//
+// Kernels. The x86 versions are compiled for their instruction set with target
+// attributes and picked at runtime, so one binary runs on any x86-64 CPU.
+//
+static void addColumnScalar(int16_t* acc, const int16_t* column)
+{
+    for (int i = 0; i < NnueHidden; i++) acc[i] = static_cast<int16_t>(acc[i] + column[i]);
+}
+
+static void subColumnScalar(int16_t* acc, const int16_t* column)
+{
+    for (int i = 0; i < NnueHidden; i++) acc[i] = static_cast<int16_t>(acc[i] - column[i]);
+}
+
+static int32_t outputScalar(const int16_t* us, const int16_t* them, const int16_t* weights)
+{
+    int32_t sum = 0;
+    for (int i = 0; i < NnueHidden; i++) {
+        const int a = us[i] < 0 ? 0 : (us[i] > NnueClip ? NnueClip : us[i]);
+        const int b = them[i] < 0 ? 0 : (them[i] > NnueClip ? NnueClip : them[i]);
+        sum += a * weights[i] + b * weights[NnueHidden + i];
+    }
+    return sum;
+}
+
+#if defined(NNUE_X86_KERNELS)
+__attribute__((target("avx2"))) static void addColumnAvx2(int16_t* acc, const int16_t* column)
+{
+    for (int i = 0; i < NnueHidden; i += 16) {
+        __m256i* a = reinterpret_cast<__m256i*>(acc + i);
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(a, _mm256_add_epi16(_mm256_load_si256(a), c));
+    }
+}
+
+__attribute__((target("avx2"))) static void subColumnAvx2(int16_t* acc, const int16_t* column)
+{
+    for (int i = 0; i < NnueHidden; i += 16) {
+        __m256i* a = reinterpret_cast<__m256i*>(acc + i);
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(a, _mm256_sub_epi16(_mm256_load_si256(a), c));
+    }
+}
+
+__attribute__((target("avx2"))) static int32_t outputAvx2(const int16_t* us, const int16_t* them, const int16_t* weights)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i clip = _mm256_set1_epi16(NnueClip);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < NnueHidden; i += 16) {
+        const __m256i a = _mm256_min_epi16(_mm256_max_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(us + i)), zero), clip);
+        const __m256i b = _mm256_min_epi16(_mm256_max_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(them + i)), zero), clip);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i))));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(b, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + NnueHidden + i))));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+}
+
+__attribute__((target("sse4.1"))) static void addColumnSse(int16_t* acc, const int16_t* column)
+{
+    for (int i = 0; i < NnueHidden; i += 8) {
+        __m128i* a = reinterpret_cast<__m128i*>(acc + i);
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_store_si128(a, _mm_add_epi16(_mm_load_si128(a), c));
+    }
+}
+
+__attribute__((target("sse4.1"))) static void subColumnSse(int16_t* acc, const int16_t* column)
+{
+    for (int i = 0; i < NnueHidden; i += 8) {
+        __m128i* a = reinterpret_cast<__m128i*>(acc + i);
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_store_si128(a, _mm_sub_epi16(_mm_load_si128(a), c));
+    }
+}
+
+__attribute__((target("sse4.1"))) static int32_t outputSse(const int16_t* us, const int16_t* them, const int16_t* weights)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i clip = _mm_set1_epi16(NnueClip);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < NnueHidden; i += 8) {
+        const __m128i a = _mm_min_epi16(_mm_max_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(us + i)), zero), clip);
+        const __m128i b = _mm_min_epi16(_mm_max_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(them + i)), zero), clip);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i))));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(b, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + NnueHidden + i))));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+struct NnueKernels
+{
+    void (*addColumn)(int16_t*, const int16_t*);
+    void (*subColumn)(int16_t*, const int16_t*);
+    int32_t (*output)(const int16_t*, const int16_t*, const int16_t*);
+    const char* name;
+};
+
+static NnueKernels selectKernels()
+{
+#if defined(NNUE_X86_KERNELS)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return { addColumnAvx2, subColumnAvx2, outputAvx2, "avx2" };
+    if (__builtin_cpu_supports("sse4.1")) return { addColumnSse, subColumnSse, outputSse, "sse4.1" };
+#endif
+    return { addColumnScalar, subColumnScalar, outputScalar, "scalar" };
+}
+
+static const NnueKernels Kernels = selectKernels();
+
+const char* nnueKernelName()
+{
+    return Kernels.name;
+}
+
+//
+// Network file
+//
+bool NnueNetwork::load(const std::string& path)
+{
+    unload();
+    const size_t expected = NnueHeaderSize + NnueBodyValues * sizeof(int16_t);
+
+#if defined(_WIN32)
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in || static_cast<size_t>(in.tellg()) != expected) return false;
+    in.seekg(0);
+    std::vector<char> header(NnueHeaderSize);
+    in.read(header.data(), NnueHeaderSize);
+    _heapCopy = new int16_t[NnueBodyValues];
+    in.read(reinterpret_cast<char*>(_heapCopy), NnueBodyValues * sizeof(int16_t));
+    if (!in) {
+        unload();
+        return false;
+    }
+    const char* base = header.data();
+    const int16_t* body = _heapCopy;
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != expected) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, expected, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+    _mapping = mapping;
+    _mappingSize = expected;
+    const char* base = static_cast<const char*>(mapping);
+    const int16_t* body = reinterpret_cast<const int16_t*>(base + NnueHeaderSize);
+#endif
+
+    uint32_t inputs = 0;
+    uint32_t hidden = 0;
+    std::memcpy(&inputs, base + 8, 4);
+    std::memcpy(&hidden, base + 12, 4);
+    std::memcpy(&_outBias, base + 16, 4);
+    if (std::memcmp(base, NnueMagic, 8) != 0 || inputs != NnueInputs || hidden != NnueHidden) {
+        unload();
+        return false;
+    }
+
+    _ftBias = body;
+    _ftWeights = body + NnueHidden;
+    _outWeights = _ftWeights + static_cast<size_t>(NnueInputs) * NnueHidden;
+    return true;
+}
+
+void NnueNetwork::unload()
+{
+#if !defined(_WIN32)
+    if (_mapping) ::munmap(_mapping, _mappingSize);
+#endif
+    delete[] _heapCopy;
+    _heapCopy = nullptr;
+    _mapping = nullptr;
+    _mappingSize = 0;
+    _ftBias = _ftWeights = _outWeights = nullptr;
+    _outBias = 0;
+}
+
+bool NnueNetwork::writeRandom(const std::string& path, uint64_t seed)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    char header[NnueHeaderSize] = {};
+    const uint32_t inputs = NnueInputs;
+    const uint32_t hidden = NnueHidden;
+    const int32_t outBias = 0;
+    std::memcpy(header, NnueMagic, 8);
+    std::memcpy(header + 8, &inputs, 4);
+    std::memcpy(header + 12, &hidden, 4);
+    std::memcpy(header + 16, &outBias, 4);
+    out.write(header, sizeof(header));
+
+    // small weights so accumulators of ~30 active features stay well inside int16
+    auto next = [&seed]() {
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        return seed * 2685821657736338717ULL;
+    };
+    std::vector<int16_t> chunk(NnueHidden);
+    for (size_t row = 0; row < 1 + static_cast<size_t>(NnueInputs) + 2; row++) {
+        for (int16_t& value : chunk) value = static_cast<int16_t>(static_cast<int>(next() % 33) - 16);
+        out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(int16_t));
+    }
+    return static_cast<bool>(out);
+}
+
+static NnueNetwork gNetwork;
+
+bool loadNnue(const std::string& path)
+{
+    return gNetwork.load(path);
+}
+
+bool nnueLoaded()
+{
+    return gNetwork.loaded();
+}
+
+const NnueNetwork& nnueNetwork()
+{
+    return gNetwork;
+}
+
+//
+// Features
+//
+static inline int featureIndex(int perspective, int kingSquare, uint8_t code, int square)
+{
+    const int orient = perspective == White ? 0 : 56;
+    const int kind = (pieceTypeOf(code) - 1) * 2 + (pieceColorOf(code) != perspective ? 1 : 0);
+    return (kingSquare ^ orient) * 640 + kind * 64 + (square ^ orient);
+}
+
+NnueAccumulator::NnueAccumulator() : _stack(StackSize)
+{
+    reset();
+}
+
+void NnueAccumulator::reset()
+{
+    for (Entry& entry : _stack) {
+        entry.ply = -1;
+        entry.key = 0;
+        entry.computed[0] = entry.computed[1] = false;
+    }
+}
+
+void NnueAccumulator::refresh(const Position& pos, int perspective, int16_t* out) const
+{
+    const NnueNetwork& net = gNetwork;
+    std::memcpy(out, net.ftBias(), sizeof(int16_t) * NnueHidden);
+
+    const int kingSquare = bitScanForward(pos.pieces(perspective, King));
+    uint64_t pieces = pos.occupied() & ~(pos.pieces(White, King) | pos.pieces(Black, King));
+    while (pieces) {
+        const int sq = popLSB(pieces);
+        Kernels.addColumn(out, net.ftColumn(featureIndex(perspective, kingSquare, pos.pieceAt(sq), sq)));
+    }
+}
+
+// Rebuild entry's accumulator for perspective from a recent valid ancestor, applying the
+// moves since. Fails (caller refreshes) if none is close enough or the perspective's king moved.
+bool NnueAccumulator::update(const Position& pos, int perspective, Entry& entry)
+{
+    const int ply = pos.gamePly();
+    const int maxBack = ply < MaxWalkBack ? ply : MaxWalkBack;
+
+    int source = -1;
+    for (int back = 1; back <= maxBack; back++) {
+        const uint8_t moved = pos.movedPieceAt(ply - back);
+        if (pieceTypeOf(moved) == King && pieceColorOf(moved) == perspective) return false;
+
+        const Entry& candidate = _stack[(ply - back) % StackSize];
+        if (candidate.ply == ply - back && candidate.key == pos.keyAt(back) && candidate.computed[perspective]) {
+            source = ply - back;
+            break;
+        }
+    }
+    if (source < 0) return false;
+
+    const NnueNetwork& net = gNetwork;
+    int16_t* acc = entry.values[perspective];
+    std::memcpy(acc, _stack[source % StackSize].values[perspective], sizeof(int16_t) * NnueHidden);
+
+    // the perspective's king has not moved since source, so today's square is the one to index by
+    const int kingSquare = bitScanForward(pos.pieces(perspective, King));
+    auto add = [&](uint8_t code, int sq) {
+        if (pieceTypeOf(code) != King) Kernels.addColumn(acc, net.ftColumn(featureIndex(perspective, kingSquare, code, sq)));
+    };
+    auto sub = [&](uint8_t code, int sq) {
+        if (pieceTypeOf(code) != King) Kernels.subColumn(acc, net.ftColumn(featureIndex(perspective, kingSquare, code, sq)));
+    };
+
+    for (int i = source; i < ply; i++) {
+        const BitMove move = pos.moveAt(i);
+        const uint8_t moved = pos.movedPieceAt(i);
+        const uint8_t captured = pos.capturedAt(i);
+        const int color = pieceColorOf(moved);
+
+        sub(moved, move.from());
+        add(move.isPromotion() ? makePieceCode(color, move.promotionPiece()) : moved, move.to());
+        if (captured) {
+            sub(captured, move.isEnPassant() ? move.to() + (color == White ? -8 : 8) : move.to());
+        }
+        if (move.isCastle()) {
+            int rookFrom, rookTo;
+            castlingRookSquares(move.to(), rookFrom, rookTo);
+            const uint8_t rook = makePieceCode(color, Rook);
+            sub(rook, rookFrom);
+            add(rook, rookTo);
+        }
+    }
+    return true;
+}
+
+int NnueAccumulator::evaluate(const Position& pos)
+{
+    const int ply = pos.gamePly();
+    Entry& entry = _stack[ply % StackSize];
+    if (entry.ply != ply || entry.key != pos.key()) {
+        entry.ply = ply;
+        entry.key = pos.key();
+        entry.computed[0] = entry.computed[1] = false;
+    }
+
+    for (int perspective = White; perspective <= Black; perspective++) {
+        if (entry.computed[perspective]) continue;
+        if (!update(pos, perspective, entry)) refresh(pos, perspective, entry.values[perspective]);
+        entry.computed[perspective] = true;
+    }
+
+    const NnueNetwork& net = gNetwork;
+    const int us = pos.sideToMove();
+    const int32_t output = Kernels.output(entry.values[us], entry.values[us ^ 1], net.outWeights()) + net.outBias();
+    return static_cast<int>(static_cast<int64_t>(output) * NnueCentipawnScale / (NnueClip * NnueOutputScale));
+}
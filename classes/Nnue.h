@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Position.h"
+
+//
+// Efficiently updatable neural network evaluation (NNUE), CPU only.
+//
+// Features are HalfKP: for each side ("perspective"), every non-king piece on the board
+// indexed by the perspective's own king square, so 64 king squares x 10 piece kinds x 64
+// squares = 40960 inputs. The board is mirrored vertically for black so both sides see
+// the position from their own first rank.
+//
+//   input (40960, sparse) -> feature transformer (NnueHidden int16 per perspective)
+//   -> clipped ReLU [0, NnueClip] of [side to move | other side] -> one linear output
+//
+// The feature transformer output (the "accumulator") only changes by a few weight
+// columns per move, so it is updated from the parent position instead of recomputed;
+// only a move of the perspective's own king forces a full refresh.
+//
+// Weights file layout (little endian, mapped read-only with mmap):
+//   char     magic[8]        "CHESSNN1"
+//   uint32_t inputs          NnueInputs
+//   uint32_t hidden          NnueHidden
+//   int32_t  outputBias
+//   uint32_t reserved[11]    header padded to 64 bytes so the arrays stay aligned
+//   int16_t  ftBias[hidden]
+//   int16_t  ftWeights[inputs][hidden]
+//   int16_t  outWeights[2 * hidden]
+//
+constexpr int NnueInputs = 64 * 10 * 64;
+constexpr int NnueHidden = 256;
+constexpr int NnueClip = 255;          // clipped ReLU ceiling (feature transformer scale)
+constexpr int NnueOutputScale = 64;    // output weight scale
+constexpr int NnueCentipawnScale = 400;
+
+class NnueNetwork
+{
+public:
+    NnueNetwork() = default;
+    ~NnueNetwork() { unload(); }
+    NnueNetwork(const NnueNetwork&) = delete;
+    NnueNetwork& operator=(const NnueNetwork&) = delete;
+
+    // maps the file; returns false (and stays unloaded) if it is missing or malformed
+    bool load(const std::string& path);
+    void unload();
+    bool loaded() const { return _ftWeights != nullptr; }
+
+    const int16_t* ftBias() const { return _ftBias; }
+    const int16_t* ftColumn(int feature) const { return _ftWeights + static_cast<size_t>(feature) * NnueHidden; }
+    const int16_t* outWeights() const { return _outWeights; }
+    int32_t outBias() const { return _outBias; }
+
+    // writes a file with random weights of the right shape (benchmarks and tests only)
+    static bool writeRandom(const std::string& path, uint64_t seed);
+
+private:
+    const int16_t* _ftBias = nullptr;
+    const int16_t* _ftWeights = nullptr;
+    const int16_t* _outWeights = nullptr;
+    int32_t _outBias = 0;
+
+    void* _mapping = nullptr;
+    size_t _mappingSize = 0;
+    int16_t* _heapCopy = nullptr;   // used where mmap is not available
+};
+
+// The network used by the search; the search falls back to the PST evaluation when none is loaded
+bool loadNnue(const std::string& path);
+bool nnueLoaded();
+const NnueNetwork& nnueNetwork();
+
+// which accumulator/output kernels this CPU runs: "avx2", "sse4.1" or "scalar"
+const char* nnueKernelName();
+
+//
+// Per-thread accumulator stack. evaluate() finds the newest ancestor of the current
+// position whose accumulator is still valid (checked by Zobrist key), applies the moves
+// made since then and caches the result for the current ply, so a search calling it at
+// every node pays a handful of column adds per move.
+//
+class NnueAccumulator
+{
+public:
+    NnueAccumulator();
+
+    // side-to-move centipawns, like evaluate(); a network must be loaded
+    int evaluate(const Position& pos);
+
+    // forget cached accumulators (a new root position)
+    void reset();
+
+private:
+    struct alignas(64) Entry
+    {
+        int16_t values[2][NnueHidden];
+        uint64_t key;
+        int ply;
+        bool computed[2];
+    };
+
+    static constexpr int StackSize = 256;
+    // plies to walk back looking for a valid ancestor before giving up and refreshing
+    static constexpr int MaxWalkBack = 12;
+
+    void refresh(const Position& pos, int perspective, int16_t* out) const;
+    bool update(const Position& pos, int perspective, Entry& entry);
+
+    std::vector<Entry> _stack;
+};
@@ -0,0 +1,153 @@
+#include "PawnTable.h"
+#include <algorithm>
+
+static constexpr uint64_t FileA = 0x0101010101010101ULL;
+static constexpr uint64_t NotFileA = 0xfefefefefefefefeULL;
+static constexpr uint64_t NotFileH = 0x7f7f7f7f7f7f7f7fULL;
+
+// (middlegame, endgame) penalties per pawn and passed pawn bonus by relative rank
+static constexpr int DoubledMg = -10, DoubledEg = -25;
+static constexpr int IsolatedMg = -5, IsolatedEg = -15;
+static constexpr int BackwardMg = -9, BackwardEg = -20;
+static constexpr int PassedMg[8] = { 0, 5, 5, 10, 20, 35, 60, 0 };
+static constexpr int PassedEg[8] = { 0, 10, 15, 25, 45, 70, 110, 0 };
+// shield pawn on the king's second / third rank, or none on that file
+static constexpr int ShieldNear = 12, ShieldFar = 6, ShieldMissing = -10;
+
+static inline uint64_t northFill(uint64_t b)
+{
+    b |= b << 8;
+    b |= b << 16;
+    b |= b << 32;
+    return b;
+}
+
+static inline uint64_t southFill(uint64_t b)
+{
+    b |= b >> 8;
+    b |= b >> 16;
+    b |= b >> 32;
+    return b;
+}
+
+static inline uint64_t pawnAttacks(int color, uint64_t pawns)
+{
+    return color == White ? ((pawns << 9) & NotFileA) | ((pawns << 7) & NotFileH)
+                          : ((pawns >> 7) & NotFileA) | ((pawns >> 9) & NotFileH);
+}
+
+// squares strictly in front of the pawns, from color's point of view
+static inline uint64_t frontSpan(int color, uint64_t pawns)
+{
+    return color == White ? northFill(pawns << 8) : southFill(pawns >> 8);
+}
+
+static inline uint64_t adjacentFiles(int file)
+{
+    return ((file > 0) ? FileA << (file - 1) : 0) | ((file < 7) ? FileA << (file + 1) : 0);
+}
+
+static int shieldScore(uint64_t ownPawns, int color, int kingFile)
+{
+    const int nearRank = color == White ? 1 : 6;
+    const int farRank = color == White ? 2 : 5;
+    int score = 0;
+    for (int file = std::max(kingFile - 1, 0); file <= std::min(kingFile + 1, 7); file++) {
+        if (ownPawns & (1ULL << (nearRank * 8 + file))) score += ShieldNear;
+        else if (ownPawns & (1ULL << (farRank * 8 + file))) score += ShieldFar;
+        else score += ShieldMissing;
+    }
+    return score;
+}
+
+void evaluatePawns(const Position& pos, PawnEntry& entry)
+{
+    entry.key = pos.pawnKey();
+    int mg = 0;
+    int eg = 0;
+
+    for (int color = White; color <= Black; color++) {
+        const uint64_t own = pos.pieces(color, Pawn);
+        entry.attacks[color] = pawnAttacks(color, own);
+        entry.attackSpan[color] = color == White ? northFill(entry.attacks[color]) : southFill(entry.attacks[color]);
+    }
+
+    for (int color = White; color <= Black; color++) {
+        const int them = color ^ 1;
+        const uint64_t own = pos.pieces(color, Pawn);
+        const uint64_t enemy = pos.pieces(them, Pawn);
+        const int sign = color == White ? 1 : -1;
+
+        // rear pawns of a doubled file, and pawns no enemy pawn can stop or capture
+        const uint64_t doubled = own & frontSpan(them, own);
+        const uint64_t passed = own & ~(frontSpan(them, enemy) | entry.attackSpan[them]) & ~doubled;
+        // stop square covered by an enemy pawn and out of reach of any own pawn's support
+        const uint64_t stopsUnsupported = entry.attacks[them] & ~entry.attackSpan[color];
+        const uint64_t backward = own & (color == White ? stopsUnsupported >> 8 : stopsUnsupported << 8);
+        entry.passed[color] = passed;
+
+        uint64_t pawns = own;
+        while (pawns) {
+            const int sq = popLSB(pawns);
+            const uint64_t bit = 1ULL << sq;
+            const int relativeRank = color == White ? sq / 8 : 7 - sq / 8;
+            const bool isolated = (own & adjacentFiles(sq & 7)) == 0;
+
+            int pawnMg = 0;
+            int pawnEg = 0;
+            if (doubled & bit) {
+                pawnMg += DoubledMg;
+                pawnEg += DoubledEg;
+            }
+            if (isolated) {
+                pawnMg += IsolatedMg;
+                pawnEg += IsolatedEg;
+            } else if (backward & bit) {
+                pawnMg += BackwardMg;
+                pawnEg += BackwardEg;
+            }
+            if (passed & bit) {
+                pawnMg += PassedMg[relativeRank];
+                pawnEg += PassedEg[relativeRank];
+            }
+            mg += sign * pawnMg;
+            eg += sign * pawnEg;
+        }
+
+        for (int file = 0; file < 8; file++) {
+            entry.shield[color][file] = static_cast<int8_t>(shieldScore(own, color, file));
+        }
+    }
+
+    entry.mg = static_cast<int16_t>(mg);
+    entry.eg = static_cast<int16_t>(eg);
+}
+
+PawnTable::PawnTable(size_t entries)
+{
+    size_t count = 1;
+    while (count * 2 <= entries) count *= 2;
+    _entries.resize(count);
+    _mask = count - 1;
+    clear();
+}
+
+void PawnTable::clear()
+{
+    // pawn keys start from Zobrist.noPawns, so even a pawnless position cannot match a zeroed entry
+    for (PawnEntry& entry : _entries) entry = PawnEntry();
+    resetStats();
+}
+
+const PawnEntry& PawnTable::probe(const Position& pos)
+{
+    const uint64_t key = pos.pawnKey();
+    PawnEntry& entry = _entries[key & _mask];
+    _stats.probes++;
+    if (entry.key == key) {
+        _stats.hits++;
+        return entry;
+    }
+    evaluatePawns(pos, entry);
+    return entry;
+}
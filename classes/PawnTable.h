@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Position.h"
+
+//
+// Pawn structure evaluation: passed, isolated, doubled and backward pawns, plus the
+// pawn shield in front of each possible king file. All of it depends on the pawns alone,
+// which rarely move, so the results are cached by Position::pawnKey().
+//
+struct PawnEntry
+{
+    uint64_t key;
+    int16_t mg;                 // white minus black, all terms except the shield
+    int16_t eg;
+    int8_t shield[2][8];        // middlegame shield score by colour and king file
+    uint64_t passed[2];
+    uint64_t attacks[2];        // squares attacked by each side's pawns
+    uint64_t attackSpan[2];     // squares they attack now or could after advancing
+};
+
+// fill entry for pos's pawns from scratch
+void evaluatePawns(const Position& pos, PawnEntry& entry);
+
+struct PawnHashStats
+{
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+
+    PawnHashStats& operator+=(const PawnHashStats& other) {
+        probes += other.probes;
+        hits += other.hits;
+        return *this;
+    }
+    double hitRate() const { return probes ? static_cast<double>(hits) / probes : 0.0; }
+};
+
+//
+// Direct-mapped pawn cache owned by one search thread, so neither entries nor counters
+// need any synchronisation. It is kept between searches: the pawn structures of
+// consecutive moves mostly repeat.
+//
+class PawnTable
+{
+public:
+    static constexpr size_t DefaultEntries = 8192;
+
+    explicit PawnTable(size_t entries = DefaultEntries);
+
+    void clear();
+    const PawnEntry& probe(const Position& pos);
+
+    const PawnHashStats& stats() const { return _stats; }
+    void resetStats() { _stats = PawnHashStats(); }
+
+private:
+    std::vector<PawnEntry> _entries;
+    uint64_t _mask;
+    PawnHashStats _stats;
+};
@@ -0,0 +1,213 @@
+#include "Perft.h"
+#include "MoveGen.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+uint64_t perft(Position& pos, int depth)
+{
+    if (depth <= 0) return 1;
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    if (depth == 1) return static_cast<uint64_t>(moves.size());
+
+    uint64_t nodes = 0;
+    for (const BitMove& move : moves) {
+        pos.makeMove(move);
+        nodes += perft(pos, depth - 1);
+        pos.unmakeMove();
+    }
+    return nodes;
+}
+
+std::vector<PerftDivideEntry> perftDivide(Position& pos, int depth)
+{
+    std::vector<PerftDivideEntry> entries;
+    if (depth <= 0) return entries;
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    for (const BitMove& move : moves) {
+        pos.makeMove(move);
+        entries.push_back({ move, perft(pos, depth - 1) });
+        pos.unmakeMove();
+    }
+    return entries;
+}
+
+const std::vector<PerftReference>& perftReferencePositions()
+{
+    static const std::vector<PerftReference> positions = {
+        { "startpos",
+          "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+          { 20, 400, 8902, 197281, 4865609, 119060324, 3195901860ULL } },
+        { "kiwipete",
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+          { 48, 2039, 97862, 4085603, 193690690, 8031647685ULL, 0 } },
+        { "position3",
+          "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+          { 14, 191, 2812, 43238, 674624, 11030083, 178633661 } },
+        { "position4",
+          "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+          { 6, 264, 9467, 422333, 15833292, 706045033, 0 } },
+        { "position4-mirrored",
+          "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+          { 6, 264, 9467, 422333, 15833292, 706045033, 0 } },
+        { "position5",
+          "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+          { 44, 1486, 62379, 2103487, 89941194, 0, 0 } },
+        { "position6",
+          "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+          { 46, 2079, 89890, 3894594, 164075551, 6923051137ULL, 0 } },
+    };
+    return positions;
+}
+
+static uint64_t perftHashed(Position& pos, int depth, PerftHashTable* table, PerftHashCounters& counters)
+{
+    if (depth <= 0) return 1;
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    if (depth <= 1) return static_cast<uint64_t>(moves.size());
+
+    uint64_t key = 0;
+    uint64_t nodes = 0;
+    if (table) {
+        key = pos.key();
+        if (table->probe(key, depth, nodes, counters)) return nodes;
+    }
+
+    for (const BitMove& move : moves) {
+        pos.makeMove(move);
+        nodes += perftHashed(pos, depth - 1, table, counters);
+        pos.unmakeMove();
+    }
+
+    if (table) table->store(key, depth, nodes);
+    return nodes;
+}
+
+// One unit of work: up to two moves from the root, then a perft of the remaining depth
+struct PerftTask
+{
+    BitMove moves[2];
+    int moveCount;
+    int depth;
+};
+
+class PerftTaskQueue
+{
+public:
+    void push(const PerftTask& task) {
+        std::lock_guard<std::mutex> guard(_lock);
+        _tasks.push_back(task);
+    }
+    // owner end
+    bool popBack(PerftTask& task) {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_tasks.empty()) return false;
+        task = _tasks.back();
+        _tasks.pop_back();
+        return true;
+    }
+    // thief end
+    bool stealFront(PerftTask& task) {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_tasks.empty()) return false;
+        task = _tasks.front();
+        _tasks.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex _lock;
+    std::deque<PerftTask> _tasks;
+};
+
+uint64_t perftParallel(const Position& root, int depth, int threads, PerftHashTable* table, PerftStats* stats)
+{
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (depth <= 1) {
+        Position pos = root;
+        return perft(pos, depth);
+    }
+
+    if (table) table->newSearch();
+
+    // Split at the root, or root + reply when there are not enough root moves to keep every thread busy
+    std::vector<PerftTask> tasks;
+    Position pos = root;
+    MoveList rootMoves;
+    generateLegalMoves(pos, rootMoves);
+    const bool splitTwice = depth >= 3 && rootMoves.size() < threads * 4;
+    for (const BitMove& move : rootMoves) {
+        if (!splitTwice) {
+            tasks.push_back({ { move, BitMove::none() }, 1, depth - 1 });
+            continue;
+        }
+        pos.makeMove(move);
+        MoveList replies;
+        generateLegalMoves(pos, replies);
+        for (const BitMove& reply : replies) {
+            tasks.push_back({ { move, reply }, 2, depth - 2 });
+        }
+        pos.unmakeMove();
+    }
+
+    std::vector<PerftTaskQueue> queues(threads);
+    for (size_t i = 0; i < tasks.size(); i++) {
+        queues[i % threads].push(tasks[i]);
+    }
+
+    std::vector<uint64_t> threadNodes(threads, 0);
+    std::vector<uint64_t> threadTasks(threads, 0);
+    std::vector<PerftHashCounters> threadCounters(threads);
+
+    auto worker = [&](int id) {
+        Position local = root;
+        PerftTask task;
+        uint64_t nodes = 0;
+        uint64_t count = 0;
+        PerftHashCounters counters;
+        for (;;) {
+            bool found = queues[id].popBack(task);
+            for (int i = 1; !found && i < threads; i++) {
+                found = queues[(id + i) % threads].stealFront(task);
+            }
+            // all tasks are queued up front, so empty everywhere means done
+            if (!found) break;
+
+            for (int i = 0; i < task.moveCount; i++) local.makeMove(task.moves[i]);
+            nodes += perftHashed(local, task.depth, table, counters);
+            for (int i = 0; i < task.moveCount; i++) local.unmakeMove();
+            count++;
+        }
+        threadNodes[id] = nodes;
+        threadTasks[id] = count;
+        threadCounters[id] = counters;
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; i++) pool.emplace_back(worker, i);
+    worker(0);
+    for (std::thread& t : pool) t.join();
+
+    uint64_t total = 0;
+    for (uint64_t n : threadNodes) total += n;
+
+    if (stats) {
+        stats->threadNodes = threadNodes;
+        stats->threadTasks = threadTasks;
+        stats->hashHits = 0;
+        stats->hashProbes = 0;
+        for (const PerftHashCounters& counters : threadCounters) {
+            stats->hashHits += counters.hits;
+            stats->hashProbes += counters.probes;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Position.h"
+
+// Leaf-node count to the given depth. The last ply is bulk counted (size of the legal move list).
+uint64_t perft(Position& pos, int depth);
+
+struct PerftDivideEntry
+{
+    BitMove move;
+    uint64_t nodes;
+};
+
+// perft split by root move, in generation order
+std::vector<PerftDivideEntry> perftDivide(Position& pos, int depth);
+
+//
+// Shared perft hash table. Each entry is two 64-bit words, written without locks:
+//   check = key ^ data
+//   data  = nodes << 8 | depth
+// A reader accepts the entry only if check ^ data gives back its key, so a torn write by
+// another thread just looks like a miss. Index mixes the depth in so every depth of the
+// same position gets its own slot.
+//
+// The caller owns the table and keeps it across perfts, so its memory is allocated and
+// zeroed once. newSearch() salts the keys for the next root: entries from earlier runs
+// stop verifying, which keeps hit rates and timings per run without clearing the table.
+//
+// Probe and hit counts are kept by each thread (see PerftHashCounters) rather than in the
+// table, so the counting adds no shared cache line to every node.
+//
+struct PerftHashCounters
+{
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+};
+
+class PerftHashTable
+{
+public:
+    explicit PerftHashTable(size_t megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Entry) <= megabytes * 1024 * 1024) count *= 2;
+        _entries = std::vector<Entry>(count);
+        _mask = count - 1;
+    }
+
+    void newSearch() {
+        _generation++;
+        _salt = _generation * 0xD6E8FEB86659FD93ULL;
+    }
+
+    bool probe(uint64_t key, int depth, uint64_t& nodes, PerftHashCounters& counters) const {
+        counters.probes++;
+        key ^= _salt;
+        const Entry& entry = _entries[index(key, depth)];
+        const uint64_t data = entry.data.load(std::memory_order_relaxed);
+        const uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key || static_cast<int>(data & 0xFF) != depth) return false;
+        nodes = data >> 8;
+        counters.hits++;
+        return true;
+    }
+
+    void store(uint64_t key, int depth, uint64_t nodes) {
+        key ^= _salt;
+        Entry& entry = _entries[index(key, depth)];
+        const uint64_t data = (nodes << 8) | static_cast<uint64_t>(depth);
+        entry.check.store(key ^ data, std::memory_order_relaxed);
+        entry.data.store(data, std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry
+    {
+        std::atomic<uint64_t> check{ 0 };
+        std::atomic<uint64_t> data{ 0 };
+    };
+
+    size_t index(uint64_t key, int depth) const {
+        return static_cast<size_t>((key ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ULL)) & _mask);
+    }
+
+    std::vector<Entry> _entries;
+    size_t _mask = 0;
+    uint64_t _generation = 0;
+    uint64_t _salt = 0;
+};
+
+//
+// Multi-threaded perft. The root is split into tasks (root move, or root move + reply
+// for deeper searches) that are dealt round-robin onto per-thread deques; a thread works
+// its own deque from the back and steals from the front of the others when it runs dry.
+// All threads share one lock-free hash table keyed by (zobrist key, depth), so subtrees
+// reached by transposition are only counted once.
+//
+struct PerftStats
+{
+    std::vector<uint64_t> threadNodes;   // leaf nodes counted by each thread
+    std::vector<uint64_t> threadTasks;   // tasks run by each thread (including stolen ones)
+    uint64_t hashHits = 0;
+    uint64_t hashProbes = 0;
+};
+
+// threads <= 0 uses every hardware thread; a null table disables hashing
+uint64_t perftParallel(const Position& pos, int depth, int threads, PerftHashTable* table, PerftStats* stats = nullptr);
+
+struct PerftReference
+{
+    const char* name;
+    const char* fen;
+    uint64_t nodes[7]; // expected node counts for depth 1..7, 0 = not listed
+};
+
+// The standard perft test positions (chessprogramming wiki) with their published node counts
+const std::vector<PerftReference>& perftReferencePositions();
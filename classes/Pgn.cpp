@@ -0,0 +1,190 @@
+#include "Pgn.h"
+#include "MoveGen.h"
+#include <cctype>
+
+static PgnResult parseResult(const std::string& token)
+{
+    if (token == "1-0") return PgnResult::WhiteWins;
+    if (token == "0-1") return PgnResult::BlackWins;
+    if (token == "1/2-1/2") return PgnResult::Draw;
+    return PgnResult::Unknown;
+}
+
+// value of a tag pair line such as [Result "1-0"]
+static std::string tagValue(const std::string& line)
+{
+    const size_t open = line.find('"');
+    const size_t close = line.rfind('"');
+    if (open == std::string::npos || close <= open) return "";
+    return line.substr(open + 1, close - open - 1);
+}
+
+bool parsePgnGame(const std::string& text, PgnGame& game, size_t maxMoves)
+{
+    game = PgnGame();
+    bool movetext = false;
+    int variationDepth = 0;
+    bool inComment = false;
+
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = text.size();
+        const std::string line = text.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        if (!inComment && !line.empty() && line[0] == '[') {
+            if (line.compare(0, 8, "[Result ") == 0) game.result = parseResult(tagValue(line));
+            else if (line.compare(0, 5, "[FEN ") == 0) game.fen = tagValue(line);
+            continue;
+        }
+
+        size_t i = 0;
+        while (i < line.size()) {
+            const char c = line[i];
+            if (inComment) {
+                if (c == '}') inComment = false;
+                i++;
+            } else if (c == '{') {
+                inComment = true;
+                i++;
+            } else if (c == ';') {
+                break;   // comment to the end of the line
+            } else if (c == '(') {
+                variationDepth++;
+                i++;
+            } else if (c == ')') {
+                if (variationDepth > 0) variationDepth--;
+                i++;
+            } else if (std::isspace(static_cast<unsigned char>(c))) {
+                i++;
+            } else {
+                size_t end = i;
+                while (end < line.size() && !std::isspace(static_cast<unsigned char>(line[end])) &&
+                       line[end] != '{' && line[end] != '(' && line[end] != ')' && line[end] != ';') {
+                    end++;
+                }
+                std::string token = line.substr(i, end - i);
+                i = end;
+                movetext = true;
+                if (variationDepth > 0 || token[0] == '$') continue;
+
+                // "12." and "12..." prefixes, possibly glued to the move ("12.e4")
+                size_t digits = 0;
+                while (digits < token.size() && std::isdigit(static_cast<unsigned char>(token[digits]))) digits++;
+                if (digits > 0 && digits < token.size() && token[digits] == '.') {
+                    while (digits < token.size() && token[digits] == '.') digits++;
+                    token.erase(0, digits);
+                    if (token.empty()) continue;
+                }
+
+                const PgnResult result = parseResult(token);
+                if (result != PgnResult::Unknown || token == "*") {
+                    if (result != PgnResult::Unknown) game.result = result;
+                    return true;
+                }
+                if (game.moves.size() < maxMoves) game.moves.push_back(token);
+            }
+        }
+    }
+    return movetext;
+}
+
+static ChessPiece pieceFromLetter(char letter)
+{
+    switch (letter) {
+    case 'N': return Knight;
+    case 'B': return Bishop;
+    case 'R': return Rook;
+    case 'Q': return Queen;
+    case 'K': return King;
+    default: return NoPiece;
+    }
+}
+
+BitMove parseSAN(const Position& pos, const std::string& text)
+{
+    // drop check/mate marks and annotations
+    std::string san = text;
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) san.pop_back();
+    if (san.size() < 2) return BitMove::none();
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        const bool kingSide = san.size() == 3;
+        for (const BitMove& move : moves) {
+            if (move.isCastle() && ((move.to() & 7) == 6) == kingSide) return move;
+        }
+        return BitMove::none();
+    }
+
+    // piece letter, optional disambiguation, optional 'x', destination, optional promotion
+    ChessPiece piece = Pawn;
+    size_t i = 0;
+    if (pieceFromLetter(san[0]) != NoPiece) {
+        piece = pieceFromLetter(san[0]);
+        i = 1;
+    }
+    ChessPiece promotion = NoPiece;
+    const size_t equals = san.find('=');
+    if (equals != std::string::npos) {
+        if (equals + 1 >= san.size()) return BitMove::none();
+        promotion = pieceFromLetter(san[equals + 1]);
+        san.erase(equals);
+    } else if (piece == Pawn && san.size() >= 3 && pieceFromLetter(san.back()) != NoPiece) {
+        // "e8Q" without the '='
+        promotion = pieceFromLetter(san.back());
+        san.pop_back();
+    }
+    if (san.size() < i + 2) return BitMove::none();
+
+    const char toFile = san[san.size() - 2];
+    const char toRank = san[san.size() - 1];
+    if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8') return BitMove::none();
+    const int to = (toRank - '1') * 8 + (toFile - 'a');
+
+    int fromFile = -1;
+    int fromRank = -1;
+    for (size_t j = i; j + 2 < san.size(); j++) {
+        const char c = san[j];
+        if (c >= 'a' && c <= 'h') fromFile = c - 'a';
+        else if (c >= '1' && c <= '8') fromRank = c - '1';
+    }
+
+    for (const BitMove& move : moves) {
+        if (move.to() != to || move.isCastle()) continue;
+        if (pieceTypeOf(pos.pieceAt(move.from())) != piece) continue;
+        if (fromFile >= 0 && (move.from() & 7) != fromFile) continue;
+        if (fromRank >= 0 && (move.from() >> 3) != fromRank) continue;
+        if (move.promotionPiece() != promotion) continue;
+        return move;
+    }
+    return BitMove::none();
+}
+
+bool PgnSplitter::addLine(const std::string& line, std::string& game)
+{
+    bool completed = false;
+    if (!line.empty() && line[0] == '[' && _inMovetext) {
+        game.swap(_current);
+        _current.clear();
+        _inMovetext = false;
+        completed = true;
+    } else if (!line.empty() && line[0] != '[' && line.find_first_not_of(" \t\r") != std::string::npos) {
+        _inMovetext = true;
+    }
+    _current += line;
+    _current += '\n';
+    return completed;
+}
+
+bool PgnSplitter::finish(std::string& game)
+{
+    if (!_inMovetext) return false;
+    game.swap(_current);
+    _current.clear();
+    _inMovetext = false;
+    return true;
+}
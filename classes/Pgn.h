@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Position.h"
+
+//
+// Minimal PGN reading: enough of the format to replay games from collections.
+// Tags other than Result and FEN are ignored; comments ({...} and ; to end of line),
+// recursive variations, numeric annotation glyphs and move numbers are skipped.
+//
+enum class PgnResult { Unknown, WhiteWins, BlackWins, Draw };
+
+struct PgnGame
+{
+    PgnResult result = PgnResult::Unknown;
+    std::string fen;                  // empty for the standard start position
+    std::vector<std::string> moves;   // SAN, mainline only
+};
+
+// Parse one game's text (tag section and movetext); false when no movetext was found
+bool parsePgnGame(const std::string& text, PgnGame& game, size_t maxMoves = SIZE_MAX);
+
+// The legal move written in SAN ("Nbd7", "exd5", "e8=Q+", "O-O"), or a null move
+BitMove parseSAN(const Position& pos, const std::string& san);
+
+//
+// Splits a PGN stream into games, a line at a time, so files of any size can be read
+// with constant memory. Feed lines in order; a game is complete when the next one's tags
+// start (or at the end, with finish()).
+//
+class PgnSplitter
+{
+public:
+    // true when line completed the previous game, which is then moved into game
+    bool addLine(const std::string& line, std::string& game);
+    // the last game, if any
+    bool finish(std::string& game);
+
+private:
+    std::string _current;
+    bool _inMovetext = false;
+};
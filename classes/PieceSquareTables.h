@@ -0,0 +1,145 @@
+#pragma once
+
+//
+// Tapered (middlegame / endgame) material and piece-square values. Position keeps the
+// sums of these up to date in make/unmake, and evaluate() blends them by game phase.
+//
+// The tables are written from white's side the way a board diagram reads (first row is
+// rank 8), so a white piece on square sq uses [sq ^ 56] and a black piece uses [sq].
+//
+
+// game phase: 24 with all minor and major pieces on the board, 0 with none
+constexpr int PhaseWeight[7] = { 0, 0, 1, 1, 2, 4, 0 };
+constexpr int MaxPhase = 24;
+
+constexpr int PieceValueMg[7] = { 0, 82, 337, 365, 477, 1025, 0 };
+constexpr int PieceValueEg[7] = { 0, 94, 281, 297, 512, 936, 0 };
+
+constexpr int PawnTableMg[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     10,  10,  20,  30,  30,  20,  10,  10,
+      5,   5,  10,  25,  25,  10,   5,   5,
+      0,   0,   0,  20,  20,   0,   0,   0,
+      5,  -5, -10,   0,   0, -10,  -5,   5,
+      5,  10,  10, -20, -20,  10,  10,   5,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+// passed or not, an advanced pawn is worth more once the pieces come off
+constexpr int PawnTableEg[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     80,  80,  80,  80,  80,  80,  80,  80,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     30,  30,  30,  30,  30,  30,  30,  30,
+     15,  15,  15,  15,  15,  15,  15,  15,
+      5,   5,   5,   5,   5,   5,   5,   5,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+constexpr int KnightTable[64] = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  15,  20,  20,  15,   0, -30,
+    -30,   5,  10,  15,  15,  10,   5, -30,
+    -40, -20,   0,   5,   5,   0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50
+};
+
+constexpr int BishopTable[64] = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20
+};
+
+constexpr int RookTableMg[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,  10,  10,  10,  10,  10,  10,   5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+      0,   0,   0,   5,   5,   0,   0,   0
+};
+
+constexpr int RookTableEg[64] = {
+      5,   5,   5,   5,   5,   5,   5,   5,
+     10,  10,  10,  10,  10,  10,  10,  10,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+constexpr int QueenTable[64] = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+      0,   0,   5,   5,   5,   5,   0,  -5,
+    -10,   5,   5,   5,   5,   5,   0, -10,
+    -10,   0,   5,   0,   0,   0,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20
+};
+
+// middlegame king hides behind its pawns
+constexpr int KingTableMg[64] = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+     20,  20,   0,   0,   0,   0,  20,  20,
+     20,  30,  10,   0,   0,  10,  30,  20
+};
+
+// endgame king heads for the centre
+constexpr int KingTableEg[64] = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50
+};
+
+//
+// Material + table value for each of Position's 12 piece slots (white pawn..king, then
+// black), already signed from white's point of view, so Position just adds and subtracts.
+//
+struct TaperedTables
+{
+    int mg[12][64];
+    int eg[12][64];
+
+    constexpr TaperedTables() : mg(), eg() {
+        const int* tablesMg[7] = { nullptr, PawnTableMg, KnightTable, BishopTable, RookTableMg, QueenTable, KingTableMg };
+        const int* tablesEg[7] = { nullptr, PawnTableEg, KnightTable, BishopTable, RookTableEg, QueenTable, KingTableEg };
+        for (int color = 0; color < 2; color++) {
+            const int sign = color == 0 ? 1 : -1;
+            const int flip = color == 0 ? 56 : 0;
+            for (int piece = 1; piece <= 6; piece++) {
+                for (int sq = 0; sq < 64; sq++) {
+                    mg[color * 6 + piece - 1][sq] = sign * (PieceValueMg[piece] + tablesMg[piece][sq ^ flip]);
+                    eg[color * 6 + piece - 1][sq] = sign * (PieceValueEg[piece] + tablesEg[piece][sq ^ flip]);
+                }
+            }
+        }
+    }
+};
+
+inline constexpr TaperedTables PieceSquare;
@@ -0,0 +1,270 @@
+#include "PolyglotBook.h"
+#include "MoveGen.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t PolyglotRandom[PolyglotRandomCount];
+static bool PolyglotRandomLoaded = false;
+
+constexpr int PolyglotCastleOffset = 768;
+constexpr int PolyglotEnPassantOffset = 772;
+constexpr int PolyglotTurnOffset = 780;
+
+bool loadPolyglotRandom(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+    std::stringstream text;
+    text << in.rdbuf();
+    const std::string content = text.str();
+
+    // every 0x... token in order; suffixes such as ULL and the separators are skipped
+    uint64_t values[PolyglotRandomCount];
+    int count = 0;
+    for (size_t pos = content.find("0x"); pos != std::string::npos; pos = content.find("0x", pos + 2)) {
+        if (count == PolyglotRandomCount) return false;
+        values[count++] = std::strtoull(content.c_str() + pos, nullptr, 16);
+    }
+    if (count != PolyglotRandomCount) return false;
+
+    std::copy(std::begin(values), std::end(values), PolyglotRandom);
+    PolyglotRandomLoaded = true;
+    return true;
+}
+
+bool polyglotRandomLoaded()
+{
+    return PolyglotRandomLoaded;
+}
+
+bool polyglotRandomStandard()
+{
+    if (!PolyglotRandomLoaded) return false;
+    Position start;
+    start.setFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    return polyglotKey(start) == PolyglotStartKey;
+}
+
+uint64_t polyglotKey(const Position& pos)
+{
+    uint64_t key = 0;
+    uint64_t occupied = pos.occupied();
+    while (occupied) {
+        const int square = popLSB(occupied);
+        const uint8_t code = pos.pieceAt(square);
+        // Polyglot kinds: black pawn 0, white pawn 1, black knight 2 ... white king 11
+        const int kind = 2 * (pieceTypeOf(code) - 1) + (pieceColorOf(code) == White ? 1 : 0);
+        key ^= PolyglotRandom[64 * kind + square];
+    }
+
+    const uint8_t castling = pos.castlingRights();
+    if (castling & WhiteKingSide) key ^= PolyglotRandom[PolyglotCastleOffset + 0];
+    if (castling & WhiteQueenSide) key ^= PolyglotRandom[PolyglotCastleOffset + 1];
+    if (castling & BlackKingSide) key ^= PolyglotRandom[PolyglotCastleOffset + 2];
+    if (castling & BlackQueenSide) key ^= PolyglotRandom[PolyglotCastleOffset + 3];
+
+    // the en passant file only counts when a pawn of the side to move stands next to the
+    // pawn that just advanced two squares
+    const int ep = pos.epSquare();
+    if (ep != NoSquare) {
+        const int us = pos.sideToMove();
+        const int file = ep & 7;
+        const int pawnRank = us == White ? 4 : 3;
+        uint64_t capturers = 0;
+        if (file > 0) capturers |= 1ULL << (pawnRank * 8 + file - 1);
+        if (file < 7) capturers |= 1ULL << (pawnRank * 8 + file + 1);
+        if (capturers & pos.pieces(us, Pawn)) key ^= PolyglotRandom[PolyglotEnPassantOffset + file];
+    }
+
+    if (pos.sideToMove() == White) key ^= PolyglotRandom[PolyglotTurnOffset];
+    return key;
+}
+
+// Square numbering (rank * 8 + file) is the same as Polyglot's
+uint16_t toPolyglotMove(const BitMove& move)
+{
+    int to = move.to();
+    if (move.isCastle()) {
+        // king takes own rook: g1 -> h1, c1 -> a1 (and the same on rank 8)
+        to = (to & 7) == 6 ? to + 1 : to - 2;
+    }
+    uint16_t result = static_cast<uint16_t>(to | (move.from() << 6));
+    if (move.isPromotion()) result |= static_cast<uint16_t>((move.promotionPiece() - Knight + 1) << 12);
+    return result;
+}
+
+BitMove fromPolyglotMove(const Position& pos, uint16_t move)
+{
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    for (const BitMove& candidate : moves) {
+        if (toPolyglotMove(candidate) == move) return candidate;
+    }
+    return BitMove::none();
+}
+
+void encodeBookEntry(const BookEntry& entry, unsigned char out[PolyglotEntrySize])
+{
+    for (int i = 0; i < 8; i++) out[i] = static_cast<unsigned char>(entry.key >> (56 - 8 * i));
+    out[8] = static_cast<unsigned char>(entry.move >> 8);
+    out[9] = static_cast<unsigned char>(entry.move);
+    out[10] = static_cast<unsigned char>(entry.weight >> 8);
+    out[11] = static_cast<unsigned char>(entry.weight);
+    for (int i = 0; i < 4; i++) out[12 + i] = static_cast<unsigned char>(entry.learn >> (24 - 8 * i));
+}
+
+static uint64_t readKey(const unsigned char* in)
+{
+    uint64_t key = 0;
+    for (int i = 0; i < 8; i++) key = (key << 8) | in[i];
+    return key;
+}
+
+BookEntry decodeBookEntry(const unsigned char* in)
+{
+    BookEntry entry;
+    entry.key = readKey(in);
+    entry.move = static_cast<uint16_t>((in[8] << 8) | in[9]);
+    entry.weight = static_cast<uint16_t>((in[10] << 8) | in[11]);
+    entry.learn = (static_cast<uint32_t>(in[12]) << 24) | (in[13] << 16) | (in[14] << 8) | in[15];
+    return entry;
+}
+
+//
+// Book file
+//
+bool PolyglotBook::open(const std::string& path)
+{
+    close();
+
+#if defined(_WIN32)
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    const size_t size = static_cast<size_t>(in.tellg());
+    if (size == 0 || size % PolyglotEntrySize != 0) return false;
+    in.seekg(0);
+    _heapCopy = new unsigned char[size];
+    in.read(reinterpret_cast<char*>(_heapCopy), size);
+    if (!in) {
+        close();
+        return false;
+    }
+    _data = _heapCopy;
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0 || static_cast<size_t>(st.st_size) % PolyglotEntrySize != 0) {
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+    // probes jump around the file
+    ::madvise(mapping, size, MADV_RANDOM);
+    _mapping = mapping;
+    _mappingSize = size;
+    _data = static_cast<const unsigned char*>(mapping);
+#endif
+
+    _entries = size / PolyglotEntrySize;
+    return true;
+}
+
+void PolyglotBook::close()
+{
+#if !defined(_WIN32)
+    if (_mapping) ::munmap(_mapping, _mappingSize);
+#endif
+    delete[] _heapCopy;
+    _heapCopy = nullptr;
+    _mapping = nullptr;
+    _mappingSize = 0;
+    _data = nullptr;
+    _entries = 0;
+}
+
+// first entry whose key is not less than key
+size_t PolyglotBook::lowerBound(uint64_t key) const
+{
+    size_t low = 0;
+    size_t high = _entries;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (readKey(_data + mid * PolyglotEntrySize) < key) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+int PolyglotBook::probe(const Position& pos, BitMove* moves, uint16_t* weights, int capacity) const
+{
+    if (!_data || !PolyglotRandomLoaded) return 0;
+
+    const uint64_t key = polyglotKey(pos);
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+
+    int count = 0;
+    for (size_t i = lowerBound(key); i < _entries && count < capacity; i++) {
+        const BookEntry entry = decodeBookEntry(_data + i * PolyglotEntrySize);
+        if (entry.key != key) break;
+        // a key collision or a corrupt entry can name a move that is not legal here
+        for (const BitMove& candidate : legal) {
+            if (toPolyglotMove(candidate) == entry.move) {
+                moves[count] = candidate;
+                weights[count] = entry.weight;
+                count++;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+BitMove PolyglotBook::pick(const Position& pos, Selection selection, uint64_t random) const
+{
+    BitMove moves[MaxMoves];
+    uint16_t weights[MaxMoves];
+    const int count = probe(pos, moves, weights, MaxMoves);
+    if (count == 0) return BitMove::none();
+
+    int best = 0;
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++) {
+        if (weights[i] > weights[best]) best = i;
+        total += weights[i];
+    }
+    if (selection == BestMove || total == 0) return moves[best];
+
+    uint64_t ticket = random % total;
+    for (int i = 0; i < count; i++) {
+        if (ticket < weights[i]) return moves[i];
+        ticket -= weights[i];
+    }
+    return moves[best];
+}
+
+static PolyglotBook Book;
+
+bool loadBook(const std::string& path)
+{
+    return Book.open(path);
+}
+
+const PolyglotBook& openingBook()
+{
+    return Book;
+}
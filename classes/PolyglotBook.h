@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Position.h"
+
+//
+// Polyglot opening books.
+//
+// A book is a file of 16-byte entries sorted by key, all fields big endian:
+//   uint64_t key      Polyglot hash of the position
+//   uint16_t move     to file (bits 0-2), to row (3-5), from file (6-8), from row (9-11),
+//                     promotion piece (12-14: none, knight, bishop, rook, queen);
+//                     castling is written as the king taking its own rook (e1h1, e8a8 ...)
+//   uint16_t weight   how good the move is; selection is proportional to it
+//   uint32_t learn    unused
+// The file is mapped read-only and searched with a binary search on the key, so a probe
+// touches a handful of pages and allocates nothing.
+//
+// The Polyglot key uses its own table of 781 random numbers (768 piece/square, 4 castling,
+// 8 en passant file, 1 side to move), published with the format. It is not built in:
+// loadPolyglotRandom() reads it from a text file holding the 781 values as 0x... hex
+// numbers in the published order (the C array from the Polyglot sources can be pasted as
+// is). Books written by other tools only match when the table is the published one, which
+// polyglotRandomStandard() checks against the format's start position key.
+//
+constexpr int PolyglotRandomCount = 781;
+constexpr size_t PolyglotEntrySize = 16;
+constexpr uint64_t PolyglotStartKey = 0x463B96181691FC9CULL;
+
+bool loadPolyglotRandom(const std::string& path);
+bool polyglotRandomLoaded();
+bool polyglotRandomStandard();
+
+uint64_t polyglotKey(const Position& pos);
+
+// move <-> Polyglot move field; fromPolyglotMove returns the matching legal move or a null move
+uint16_t toPolyglotMove(const BitMove& move);
+BitMove fromPolyglotMove(const Position& pos, uint16_t move);
+
+struct BookEntry
+{
+    uint64_t key;
+    uint16_t move;
+    uint16_t weight;
+    uint32_t learn;
+};
+
+// big-endian encoding of one entry
+void encodeBookEntry(const BookEntry& entry, unsigned char out[PolyglotEntrySize]);
+BookEntry decodeBookEntry(const unsigned char* in);
+
+class PolyglotBook
+{
+public:
+    enum Selection { BestMove, Weighted };
+    static constexpr int MaxMoves = 64;   // book moves considered per position
+
+    PolyglotBook() = default;
+    ~PolyglotBook() { close(); }
+    PolyglotBook(const PolyglotBook&) = delete;
+    PolyglotBook& operator=(const PolyglotBook&) = delete;
+
+    // maps the file; returns false (and stays closed) if it is missing or not a whole number of entries
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return _data != nullptr; }
+    size_t entryCount() const { return _entries; }
+
+    // legal book moves for pos and their weights, at most capacity of them; returns the count
+    int probe(const Position& pos, BitMove* moves, uint16_t* weights, int capacity) const;
+    // the highest-weighted move, or one drawn in proportion to the weights (random is any
+    // uniformly distributed number); a null move when the position is not in the book
+    BitMove pick(const Position& pos, Selection selection, uint64_t random) const;
+
+private:
+    size_t lowerBound(uint64_t key) const;
+
+    const unsigned char* _data = nullptr;
+    size_t _entries = 0;
+
+    void* _mapping = nullptr;
+    size_t _mappingSize = 0;
+    unsigned char* _heapCopy = nullptr;   // used where mmap is not available
+};
+
+// The book the AI consults before searching; empty until loadBook succeeds
+bool loadBook(const std::string& path);
+const PolyglotBook& openingBook();
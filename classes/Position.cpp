@@ -0,0 +1,371 @@
+#include "Position.h"
+#include "Material.h"
+#include "PieceSquareTables.h"
+#include "Zobrist.h"
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+// Castling rights that survive a move touching each square (rook/king home squares clear rights)
+static constexpr uint8_t castlingMaskFor(int square)
+{
+    switch (square) {
+        case 0:  return static_cast<uint8_t>(~WhiteQueenSide);                  // a1
+        case 4:  return static_cast<uint8_t>(~(WhiteKingSide | WhiteQueenSide)); // e1
+        case 7:  return static_cast<uint8_t>(~WhiteKingSide);                   // h1
+        case 56: return static_cast<uint8_t>(~BlackQueenSide);                  // a8
+        case 60: return static_cast<uint8_t>(~(BlackKingSide | BlackQueenSide)); // e8
+        case 63: return static_cast<uint8_t>(~BlackKingSide);                   // h8
+        default: return 0xFF;
+    }
+}
+
+struct CastlingMaskTable
+{
+    uint8_t mask[64];
+    constexpr CastlingMaskTable() : mask() {
+        for (int sq = 0; sq < 64; sq++) mask[sq] = castlingMaskFor(sq);
+    }
+};
+
+static constexpr CastlingMaskTable CASTLING_MASKS;
+
+Position::Position()
+{
+    clear();
+    _history.reserve(512);
+}
+
+void Position::clear()
+{
+    std::memset(_pieceBB, 0, sizeof(_pieceBB));
+    _occupancy[White] = _occupancy[Black] = 0ULL;
+    _occupied = 0ULL;
+    std::memset(_board, 0, sizeof(_board));
+    _sideToMove = White;
+    _castling = NoCastling;
+    _epSquare = NoSquare;
+    _halfmoveClock = 0;
+    _fullmoveNumber = 1;
+    _key = 0;
+    _pawnKey = Zobrist.noPawns;
+    _materialKey = 0;
+    _materialOverflow = 0;
+    _psqMg = _psqEg = 0;
+    _history.clear();
+}
+
+void Position::putPiece(int square, uint8_t code)
+{
+    const uint64_t bit = 1ULL << square;
+    const int color = pieceColorOf(code);
+    const int index = bitboardIndex(color, pieceTypeOf(code));
+    _pieceBB[index] |= bit;
+    _occupancy[color] |= bit;
+    _occupied |= bit;
+    _board[square] = code;
+    _key ^= Zobrist.pieces[index][square];
+    if (pieceTypeOf(code) == Pawn) _pawnKey ^= Zobrist.pieces[index][square];
+    _materialKey += MaterialStride[index];
+    if (popCount(_pieceBB[index]) > MaterialMaxCount[pieceTypeOf(code)]) _materialOverflow++;
+    _psqMg += PieceSquare.mg[index][square];
+    _psqEg += PieceSquare.eg[index][square];
+}
+
+void Position::removePiece(int square)
+{
+    const uint8_t code = _board[square];
+    const uint64_t bit = 1ULL << square;
+    const int color = pieceColorOf(code);
+    const int index = bitboardIndex(color, pieceTypeOf(code));
+    if (popCount(_pieceBB[index]) > MaterialMaxCount[pieceTypeOf(code)]) _materialOverflow--;
+    _materialKey -= MaterialStride[index];
+    _pieceBB[index] &= ~bit;
+    _occupancy[color] &= ~bit;
+    _occupied &= ~bit;
+    _board[square] = 0;
+    _key ^= Zobrist.pieces[index][square];
+    if (pieceTypeOf(code) == Pawn) _pawnKey ^= Zobrist.pieces[index][square];
+    _psqMg -= PieceSquare.mg[index][square];
+    _psqEg -= PieceSquare.eg[index][square];
+}
+
+void Position::movePiece(int from, int to)
+{
+    const uint8_t code = _board[from];
+    const uint64_t fromTo = (1ULL << from) | (1ULL << to);
+    const int color = pieceColorOf(code);
+    const int index = bitboardIndex(color, pieceTypeOf(code));
+    _pieceBB[index] ^= fromTo;
+    _occupancy[color] ^= fromTo;
+    _occupied ^= fromTo;
+    _board[to] = code;
+    _board[from] = 0;
+    _key ^= Zobrist.pieces[index][from] ^ Zobrist.pieces[index][to];
+    if (pieceTypeOf(code) == Pawn) _pawnKey ^= Zobrist.pieces[index][from] ^ Zobrist.pieces[index][to];
+    _psqMg += PieceSquare.mg[index][to] - PieceSquare.mg[index][from];
+    _psqEg += PieceSquare.eg[index][to] - PieceSquare.eg[index][from];
+}
+
+bool Position::setFEN(const std::string& fen)
+{
+    clear();
+
+    std::istringstream iss(fen);
+    std::string placement, side, castling, ep;
+    int halfmove = 0;
+    int fullmove = 1;
+    iss >> placement >> side >> castling >> ep >> halfmove >> fullmove;
+    if (placement.empty()) return false;
+
+    // ranks 8 -> 1, files a -> h
+    int x = 0;
+    int y = 7;
+    for (char c : placement) {
+        if (c == '/') {
+            y--;
+            x = 0;
+            if (y < 0) break;
+            continue;
+        }
+        if (c >= '1' && c <= '8') {
+            x += (c - '0');
+            continue;
+        }
+
+        ChessPiece piece = NoPiece;
+        switch (std::tolower(static_cast<unsigned char>(c))) {
+            case 'p': piece = Pawn;   break;
+            case 'n': piece = Knight; break;
+            case 'b': piece = Bishop; break;
+            case 'r': piece = Rook;   break;
+            case 'q': piece = Queen;  break;
+            case 'k': piece = King;   break;
+            default:  return false;
+        }
+        if (x > 7) return false;
+        const int color = std::isupper(static_cast<unsigned char>(c)) ? White : Black;
+        putPiece(y * 8 + x, makePieceCode(color, piece));
+        x++;
+    }
+
+    _sideToMove = (side == "b") ? Black : White;
+
+    for (char c : castling) {
+        switch (c) {
+            case 'K': _castling |= WhiteKingSide;  break;
+            case 'Q': _castling |= WhiteQueenSide; break;
+            case 'k': _castling |= BlackKingSide;  break;
+            case 'q': _castling |= BlackQueenSide; break;
+            default: break;
+        }
+    }
+
+    if (ep.size() == 2 && ep[0] >= 'a' && ep[0] <= 'h' && ep[1] >= '1' && ep[1] <= '8') {
+        _epSquare = (ep[1] - '1') * 8 + (ep[0] - 'a');
+    }
+
+    _halfmoveClock = halfmove;
+    _fullmoveNumber = fullmove > 0 ? fullmove : 1;
+    _key = computeZobristKey(*this);
+    return true;
+}
+
+bool Position::epCapturePossible() const
+{
+    if (_epSquare == NoSquare) return false;
+
+    const uint64_t notA = 0xfefefefefefefefeULL;
+    const uint64_t notH = 0x7f7f7f7f7f7f7f7fULL;
+    const uint64_t ep = 1ULL << _epSquare;
+    // squares from which a pawn of the side to move attacks the en-passant square
+    const uint64_t from = (_sideToMove == White) ? (((ep >> 7) & notA) | ((ep >> 9) & notH))
+                                                 : (((ep << 9) & notA) | ((ep << 7) & notH));
+    return (from & pieces(_sideToMove, Pawn)) != 0;
+}
+
+std::string Position::fen() const
+{
+    const char* notation = "0PNBRQK";
+    std::string out;
+
+    for (int y = 7; y >= 0; y--) {
+        int empty = 0;
+        for (int x = 0; x < 8; x++) {
+            const uint8_t code = _board[y * 8 + x];
+            if (!code) {
+                empty++;
+                continue;
+            }
+            if (empty) {
+                out += static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            const char c = notation[pieceTypeOf(code)];
+            out += (pieceColorOf(code) == Black) ? static_cast<char>(std::tolower(c)) : c;
+        }
+        if (empty) out += static_cast<char>('0' + empty);
+        if (y > 0) out += '/';
+    }
+
+    out += (_sideToMove == White) ? " w " : " b ";
+
+    if (_castling == NoCastling) {
+        out += '-';
+    } else {
+        if (_castling & WhiteKingSide)  out += 'K';
+        if (_castling & WhiteQueenSide) out += 'Q';
+        if (_castling & BlackKingSide)  out += 'k';
+        if (_castling & BlackQueenSide) out += 'q';
+    }
+
+    out += ' ';
+    out += (_epSquare == NoSquare) ? std::string("-") : squareToString(_epSquare);
+
+    // appended piece by piece: the chained operator+ trips a GCC 12 -Wrestrict false positive
+    out += ' ';
+    out += std::to_string(_halfmoveClock);
+    out += ' ';
+    out += std::to_string(_fullmoveNumber);
+    return out;
+}
+
+// Rook from/to squares for a castling move, given the king's destination square
+void castlingRookSquares(int kingTo, int& rookFrom, int& rookTo)
+{
+    if ((kingTo & 7) == 6) {      // king side: h-file rook to the f-file
+        rookFrom = kingTo + 1;
+        rookTo = kingTo - 1;
+    } else {                      // queen side: a-file rook to the d-file
+        rookFrom = kingTo - 2;
+        rookTo = kingTo + 1;
+    }
+}
+
+void Position::makeMove(const BitMove& move)
+{
+    const int from = move.from();
+    const int to = move.to();
+    const uint8_t moving = _board[from];
+    const int captureSquare = move.isEnPassant() ? (to + (_sideToMove == White ? -8 : 8)) : to;
+    const uint8_t captured = _board[captureSquare];
+
+    _history.push_back({ _key, move, moving, captured, _castling, static_cast<int8_t>(_epSquare), _halfmoveClock });
+    if (epCapturePossible()) _key ^= Zobrist.epFile[_epSquare & 7];
+
+    if (captured) removePiece(captureSquare);
+    movePiece(from, to);
+
+    if (move.isPromotion()) {
+        removePiece(to);
+        putPiece(to, makePieceCode(_sideToMove, move.promotionPiece()));
+    } else if (move.isCastle()) {
+        int rookFrom, rookTo;
+        castlingRookSquares(to, rookFrom, rookTo);
+        movePiece(rookFrom, rookTo);
+    }
+
+    _key ^= Zobrist.castling[_castling];
+    _castling &= CASTLING_MASKS.mask[from] & CASTLING_MASKS.mask[to];
+    _key ^= Zobrist.castling[_castling];
+
+    const bool isPawn = pieceTypeOf(moving) == Pawn;
+    _epSquare = (move.flags() == DoublePawnPush) ? (from + to) / 2 : NoSquare;
+    _halfmoveClock = (isPawn || captured) ? 0 : _halfmoveClock + 1;
+
+    if (_sideToMove == Black) _fullmoveNumber++;
+    _sideToMove ^= 1;
+    _key ^= Zobrist.side;
+    if (epCapturePossible()) _key ^= Zobrist.epFile[_epSquare & 7];
+}
+
+void Position::unmakeMove()
+{
+    if (_history.empty()) return;
+
+    const UndoInfo& undo = _history.back();
+    const BitMove move = undo.move;
+    const int from = move.from();
+    const int to = move.to();
+
+    _sideToMove ^= 1;
+    if (_sideToMove == Black) _fullmoveNumber--;
+
+    if (move.isPromotion()) {
+        removePiece(to);
+        putPiece(to, makePieceCode(_sideToMove, Pawn));
+    } else if (move.isCastle()) {
+        int rookFrom, rookTo;
+        castlingRookSquares(to, rookFrom, rookTo);
+        movePiece(rookTo, rookFrom);
+    }
+
+    movePiece(to, from);
+    if (undo.captured) {
+        const int captureSquare = move.isEnPassant() ? (to + (_sideToMove == White ? -8 : 8)) : to;
+        putPiece(captureSquare, undo.captured);
+    }
+
+    _castling = undo.castling;
+    _epSquare = undo.epSquare;
+    _halfmoveClock = undo.halfmoveClock;
+    _key = undo.key; // piece moves above also touched the key; the saved key is authoritative
+
+    _history.pop_back();
+}
+
+std::string squareToString(int square)
+{
+    std::string out;
+    out += static_cast<char>('a' + square % 8);
+    out += static_cast<char>('1' + square / 8);
+    return out;
+}
+
+std::string moveToUCI(const BitMove& move)
+{
+    if (move.isNull()) return "0000";
+    std::string out = squareToString(move.from()) + squareToString(move.to());
+    if (move.isPromotion()) {
+        out += "nbrq"[move.promotionPiece() - Knight];
+    }
+    return out;
+}
+
+uint64_t computeZobristKey(const Position& pos)
+{
+    uint64_t key = 0;
+    uint64_t occupied = pos.occupied();
+    while (occupied) {
+        const int square = popLSB(occupied);
+        const uint8_t code = pos.pieceAt(square);
+        key ^= Zobrist.pieces[pieceColorOf(code) * 6 + pieceTypeOf(code) - 1][square];
+    }
+    if (pos.sideToMove() == Black) key ^= Zobrist.side;
+    key ^= Zobrist.castling[pos.castlingRights()];
+    if (pos.epCapturePossible()) key ^= Zobrist.epFile[pos.epSquare() % 8];
+    return key;
+}
+
+uint64_t computePawnKey(const Position& pos)
+{
+    uint64_t key = Zobrist.noPawns;
+    for (int color = White; color <= Black; color++) {
+        uint64_t pawns = pos.pieces(color, Pawn);
+        while (pawns) key ^= Zobrist.pieces[color * 6][popLSB(pawns)];
+    }
+    return key;
+}
+
+int Position::repetitions() const
+{
+    // only positions with the same side to move can repeat, and nothing before the last irreversible move
+    const int window = std::min(_halfmoveClock, static_cast<int>(_history.size()));
+    int count = 0;
+    for (int pliesAgo = 4; pliesAgo <= window; pliesAgo += 2) {
+        if (keyAt(pliesAgo) == _key) count++;
+    }
+    return count;
+}
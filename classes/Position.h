@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Bitboard.h"
+
+// Colours match Player::playerNumber() (0 = white, 1 = black)
+enum ChessColor
+{
+    White = 0,
+    Black = 1
+};
+
+enum CastlingRights
+{
+    NoCastling    = 0,
+    WhiteKingSide = 1,
+    WhiteQueenSide = 2,
+    BlackKingSide = 4,
+    BlackQueenSide = 8
+};
+
+// Piece codes use the same layout as the Bit game tags in Chess:
+// piece type (1..6) in the low bits, black flag = 128.
+constexpr uint8_t BlackPieceFlag = 128;
+constexpr int NoSquare = -1;
+
+inline uint8_t makePieceCode(int color, ChessPiece piece) { return static_cast<uint8_t>(piece | (color ? BlackPieceFlag : 0)); }
+inline ChessPiece pieceTypeOf(uint8_t code) { return static_cast<ChessPiece>(code & 0x7F); }
+inline int pieceColorOf(uint8_t code) { return (code & BlackPieceFlag) ? Black : White; }
+
+// "e4", and UCI long algebraic moves such as "e2e4" or "e7e8q"
+std::string squareToString(int square);
+std::string moveToUCI(const BitMove& move);
+// rook from/to squares of a castling move, given the king's destination square
+void castlingRookSquares(int kingTo, int& rookFrom, int& rookTo);
+
+//
+// Compact board representation used by move generation and search.
+// Squares are indexed y*8+x with y=0 the bottom (white) side, which matches
+// ChessSquare::getSquareIndex() and the state string.
+//
+class Position
+{
+public:
+    Position();
+
+    // load a position from FEN (board-only FENs are accepted, the rest defaults)
+    bool setFEN(const std::string& fen);
+    std::string fen() const;
+
+    // O(1) make/unmake. unmakeMove() reverts the last move passed to makeMove().
+    // Castling moves the rook, en passant removes the passed pawn, promotions swap the pawn.
+    void makeMove(const BitMove& move);
+    void unmakeMove();
+
+    // moves played since the position was loaded, oldest first
+    BitMove moveAt(int ply) const { return _history[ply].move; }
+    BitMove lastMove() const { return _history.empty() ? BitMove::none() : _history.back().move; }
+    // the piece captured by the last move (0 if none)
+    uint8_t lastCaptured() const { return _history.empty() ? 0 : _history.back().captured; }
+    // the piece that made / was captured by the move at ply (for incremental evaluators)
+    uint8_t movedPieceAt(int ply) const { return _history[ply].moved; }
+    uint8_t capturedAt(int ply) const { return _history[ply].captured; }
+
+    uint64_t pieces(int color, ChessPiece piece) const { return _pieceBB[bitboardIndex(color, piece)]; }
+    uint64_t occupancy(int color) const { return _occupancy[color]; }
+    uint64_t occupied() const { return _occupied; }
+    uint8_t pieceAt(int square) const { return _board[square]; }
+
+    int sideToMove() const { return _sideToMove; }
+    uint8_t castlingRights() const { return _castling; }
+    int epSquare() const { return _epSquare; }
+    int halfmoveClock() const { return _halfmoveClock; }
+    int fullmoveNumber() const { return _fullmoveNumber; }
+
+    // Zobrist key, updated incrementally by makeMove/unmakeMove
+    uint64_t key() const { return _key; }
+    // key of the pawns alone, for the pawn structure cache
+    uint64_t pawnKey() const { return _pawnKey; }
+    // material signature (see Material.h), valid unless promotions pushed a count past the usual maximum
+    uint32_t materialKey() const { return _materialKey; }
+    bool materialKeyValid() const { return _materialOverflow == 0; }
+    // key of the position ply moves ago (0 = current), for repetition checks
+    uint64_t keyAt(int pliesAgo) const { return pliesAgo == 0 ? _key : _history[_history.size() - pliesAgo].key; }
+    // true when the side to move has a pawn that could capture en passant; only then is the
+    // en-passant file part of the key, so positions that differ in nothing else still match
+    bool epCapturePossible() const;
+    // how many earlier positions since the last capture or pawn move have the same key
+    int repetitions() const;
+
+    // material + piece-square sums from white's side, kept up to date by make/unmake
+    int psqMg() const { return _psqMg; }
+    int psqEg() const { return _psqEg; }
+
+    // number of moves made since the position was loaded
+    int gamePly() const { return static_cast<int>(_history.size()); }
+
+private:
+    struct UndoInfo
+    {
+        uint64_t key;
+        BitMove move;
+        uint8_t moved;
+        uint8_t captured;
+        uint8_t castling;
+        int8_t epSquare;
+        int halfmoveClock;
+    };
+
+    static int bitboardIndex(int color, ChessPiece piece) { return color * 6 + (piece - 1); }
+
+    void clear();
+    void putPiece(int square, uint8_t code);
+    void removePiece(int square);
+    void movePiece(int from, int to);
+
+    // 12 piece bitboards: white pawn..king, then black pawn..king
+    uint64_t _pieceBB[12];
+    uint64_t _occupancy[2];
+    uint64_t _occupied;
+    // mailbox copy for O(1) "what is on this square"
+    uint8_t _board[64];
+
+    int _sideToMove;
+    uint8_t _castling;
+    int _epSquare;
+    int _halfmoveClock;
+    int _fullmoveNumber;
+    uint64_t _key;
+    uint64_t _pawnKey;
+    uint32_t _materialKey;
+    int _materialOverflow;    // pieces beyond MaterialMaxCount
+    int _psqMg;
+    int _psqEg;
+
+    std::vector<UndoInfo> _history;
+};
@@ -0,0 +1,138 @@
+#include "ReplySpeculator.h"
+#include "MoveGen.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+void ReplySpeculator::start(const Position& pos, const SearchLimits& limits, int replies)
+{
+    stop();
+
+    _active = true;
+    _selected = -1;
+    _count = 0;
+    _cancel.store(false, std::memory_order_relaxed);
+    _launched.store(false, std::memory_order_relaxed);
+    _tt.newSearch();
+    if (!_ranker) _ranker = std::make_unique<Search>(_tt);
+    _launcher = std::thread(&ReplySpeculator::launch, this, pos, limits, std::clamp(replies, 1, MaxReplies));
+}
+
+// Launcher thread: rank the opponent's replies, then start one search per kept reply
+void ReplySpeculator::launch(Position pos, SearchLimits limits, int replies)
+{
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+
+    SearchLimits shallow;
+    shallow.maxDepth = RankDepth;
+    // scores from the opponent's point of view: their most dangerous replies come first
+    std::vector<std::pair<int, BitMove>> ranked;
+    for (const BitMove& move : moves) {
+        if (_cancel.load(std::memory_order_relaxed)) return;
+        Position child = pos;
+        child.makeMove(move);
+        MoveList answers;
+        generateLegalMoves(child, answers);
+        int score;
+        if (answers.empty()) score = inCheck(child) ? ScoreMate : ScoreDraw;
+        else score = -_ranker->think(child, shallow).score;
+        ranked.emplace_back(score, move);
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    if (_cancel.load(std::memory_order_relaxed)) return;
+
+    _count = std::min(replies, static_cast<int>(ranked.size()));
+    for (int i = 0; i < _count; i++) {
+        Slot& slot = _slots[i];
+        slot.reply = ranked[i].second;
+        if (!slot.search) slot.search = std::make_unique<Search>(_tt);
+        slot.done.store(false, std::memory_order_relaxed);
+        Position root = pos;
+        root.makeMove(slot.reply);
+        slot.thread = std::thread([&slot, root, limits]() {
+            slot.result = slot.search->think(root, limits);
+            slot.done.store(true, std::memory_order_release);
+        });
+    }
+    _launched.store(true, std::memory_order_release);
+}
+
+bool ReplySpeculator::select(const BitMove& reply)
+{
+    if (!_active) return false;
+    _selectTime = std::chrono::steady_clock::now();
+    // ranking takes a few milliseconds; an opponent that answers faster waits for it here
+    joinLauncher();
+
+    int hit = -1;
+    for (int i = 0; i < _count; i++) {
+        if (_slots[i].reply == reply) hit = i;
+    }
+    // signal every search first so they wind down together
+    for (int i = 0; i < _count; i++) {
+        if (i != hit && _slots[i].search) _slots[i].search->stop();
+    }
+    for (int i = 0; i < _count; i++) {
+        if (i != hit) stopSlot(_slots[i]);
+    }
+
+    _stats.rounds++;
+    if (hit < 0) {
+        _active = false;
+        return false;
+    }
+    _stats.hits++;
+    _selected = hit;
+    if (_slots[hit].done.load(std::memory_order_acquire)) _stats.immediate++;
+    return true;
+}
+
+bool ReplySpeculator::takeResult(SearchResult& result)
+{
+    if (_selected < 0) return false;
+    Slot& slot = _slots[_selected];
+    if (!slot.done.load(std::memory_order_acquire)) return false;
+
+    slot.thread.join();
+    result = slot.result;
+    _stats.hitLatencyMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _selectTime).count();
+    _selected = -1;
+    _active = false;
+    return true;
+}
+
+void ReplySpeculator::stop()
+{
+    _cancel.store(true, std::memory_order_relaxed);
+    joinLauncher();
+    for (int i = 0; i < _count; i++) _slots[i].search->stop();
+    for (int i = 0; i < _count; i++) stopSlot(_slots[i]);
+    _count = 0;
+    _launched.store(false, std::memory_order_relaxed);
+    _selected = -1;
+    _active = false;
+}
+
+uint64_t ReplySpeculator::nodes() const
+{
+    uint64_t total = 0;
+    for (int i = 0; i < replyCount(); i++) total += _slots[i].search->nodes();
+    return total;
+}
+
+// think() clears the stop flag when it starts, so keep asking until the search is done
+void ReplySpeculator::stopSlot(Slot& slot)
+{
+    if (!slot.thread.joinable()) return;
+    while (!slot.done.load(std::memory_order_acquire)) {
+        slot.search->stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    slot.thread.join();
+}
+
+void ReplySpeculator::joinLauncher()
+{
+    if (_launcher.joinable()) _launcher.join();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "Position.h"
+#include "Search.h"
+
+struct SpeculationStats
+{
+    int rounds = 0;             // opponent moves that were speculated on
+    int hits = 0;               // the opponent played one of the speculated replies
+    int immediate = 0;          // hits whose answer was already finished
+    double hitLatencyMs = 0.0;  // summed over hits: opponent's move until takeResult() got the answer
+
+    double hitRate() const { return rounds ? static_cast<double>(hits) / rounds : 0.0; }
+    double meanLatencyMs() const { return hits ? hitLatencyMs / hits : 0.0; }
+};
+
+//
+// Speculative reply search: while the opponent thinks, search our answer to each of their
+// most plausible replies at once. start() ranks every legal reply with a shallow search
+// (on a launcher thread, so the caller is not held up), then gives each of the top replies
+// its own thread running an ordinary iterative-deepening search with the caller's limits.
+// All of them share the transposition table. Once the opponent moves, select() keeps the
+// matching search and stops the rest; its answer is often complete by then, so the move
+// can be played without any wait.
+//
+// Not thread-safe: start/select/takeResult/stop and the queries all belong to one thread.
+//
+class ReplySpeculator
+{
+public:
+    static constexpr int MaxReplies = 8;
+    static constexpr int RankDepth = 2;   // depth of the ranking search after each reply
+
+    explicit ReplySpeculator(TranspositionTable& tt) : _tt(tt) { }
+    ~ReplySpeculator() { stop(); }
+
+    // pos has the opponent to move; replies is how many of their moves to search (1..MaxReplies)
+    void start(const Position& pos, const SearchLimits& limits, int replies);
+    bool active() const { return _active; }
+
+    // the opponent played reply: true when it was speculated on, and then that search is
+    // kept (takeResult) and every other one stopped; false stops them all
+    bool select(const BitMove& reply);
+    // after a successful select(): true once the kept search has finished, with its result
+    bool takeResult(SearchResult& result);
+
+    void stop();
+
+    // the replies being searched, best ranked first; empty while the launcher is still ranking
+    int replyCount() const { return _launched.load(std::memory_order_acquire) ? _count : 0; }
+    BitMove reply(int index) const { return _slots[index].reply; }
+    BitMove selectedReply() const { return _selected >= 0 ? _slots[_selected].reply : BitMove::none(); }
+    uint64_t nodes() const;
+
+    const SpeculationStats& stats() const { return _stats; }
+
+private:
+    struct Slot
+    {
+        BitMove reply = BitMove::none();
+        std::unique_ptr<Search> search;
+        std::thread thread;
+        SearchResult result;              // written by the slot's thread before done is set
+        std::atomic<bool> done{ true };
+    };
+
+    void launch(Position pos, SearchLimits limits, int replies);
+    void stopSlot(Slot& slot);
+    void joinLauncher();
+
+    TranspositionTable& _tt;
+    std::unique_ptr<Search> _ranker;
+    std::thread _launcher;
+    std::atomic<bool> _cancel{ false };
+    std::atomic<bool> _launched{ false };   // _count and the slots' replies are valid
+    Slot _slots[MaxReplies];
+    int _count = 0;
+
+    bool _active = false;
+    int _selected = -1;
+    std::chrono::steady_clock::time_point _selectTime;
+    SpeculationStats _stats;
+};
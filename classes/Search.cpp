@@ -0,0 +1,506 @@
+#include "Search.h"
+#include "Evaluate.h"
+#include "MoveGen.h"
+#include "StaticExchange.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+
+// nodes between clock reads while a step() has a time budget
+static constexpr uint64_t SlicePollNodes = 64;
+
+SearchResult Search::think(const Position& pos, const SearchLimits& limits)
+{
+    start(pos, limits);
+    while (!step(0)) { }
+    return _result;
+}
+
+void Search::start(const Position& pos, const SearchLimits& limits)
+{
+    _startTime = std::chrono::steady_clock::now();
+
+    _pos = pos;
+    _limits = limits;
+    _nodes.store(0, std::memory_order_relaxed);
+    _ttStats = TTStats();
+    _pawns.resetStats();
+    _history.age();
+    _useNnue = nnueLoaded();
+    if (_useNnue) _nnue.reset();
+    _stop.store(false, std::memory_order_relaxed);
+    _pondering = limits.ponderHit && !limits.ponderHit->load(std::memory_order_acquire);
+    _time.start(limits);
+    _useTime = _threadIndex == 0 && _time.enabled();
+
+    _result = SearchResult();
+    _result.softLimitMs = _time.softLimitMs();
+    _result.hardLimitMs = _time.hardLimitMs();
+    _ply = -1;
+    _depth = 0;
+    _maxDepth = std::clamp(limits.maxDepth, 1, MaxPly - 1);
+    _finished = false;
+
+    // fall back to any legal move, so a search stopped before depth 1 still answers
+    MoveList rootMoves;
+    generateLegalMoves(_pos, rootMoves);
+    if (rootMoves.empty()) {
+        finishSearch();
+        return;
+    }
+    _result.bestMove = rootMoves[0];
+    _result.pv.push_back(rootMoves[0]);
+}
+
+bool Search::step(int64_t budgetMicros, uint64_t budgetNodes)
+{
+    if (_finished) return true;
+
+    _sliceLimited = budgetMicros > 0 || budgetNodes > 0;
+    _sliceEnd = budgetMicros > 0 ? std::chrono::steady_clock::now() + std::chrono::microseconds(budgetMicros)
+                                 : std::chrono::steady_clock::time_point::max();
+    _sliceStartNodes = nodes();
+    _sliceEndNodes = budgetNodes > 0 ? _sliceStartNodes + budgetNodes : std::numeric_limits<uint64_t>::max();
+    // the clock kept running while the caller had control
+    checkLimits();
+
+    for (;;) {
+        if (_ply < 0) {
+            if (++_depth > _maxDepth) break;
+            // helpers stagger their depths so they do not just repeat the main thread's work
+            if (_threadIndex > 0 && _depth > 1 && _depth < _maxDepth && ((_depth + _threadIndex) & 1) == 0) continue;
+
+            Frame& root = _stack[0];
+            root.alpha = -ScoreInfinite;
+            root.beta = ScoreInfinite;
+            root.depth = _depth;
+            root.quiescence = false;
+            root.entered = false;
+            _ply = 0;
+        }
+
+        const RunState state = run();
+        if (state == RunState::Paused) return false;
+        _ply = -1;
+        if (state == RunState::Aborted || iterationCompleted(_rootScore)) break;
+    }
+
+    finishSearch();
+    return true;
+}
+
+// Record a finished iteration; true when the search should stop here
+bool Search::iterationCompleted(int score)
+{
+    _result.score = score;
+    _result.depth = _depth;
+    _result.pv.assign(_pv[0], _pv[0] + _pvLength[0]);
+    if (!_result.pv.empty()) _result.bestMove = _result.pv[0];
+    _result.nodes = nodes();
+    _result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _startTime).count();
+    _result.tt = _ttStats;
+    _result.pawns = _pawns.stats();
+    if (_onIteration) _onIteration(_result);
+
+    // a forced mate was found; deeper iterations cannot improve on it
+    if (std::abs(score) >= ScoreMateInMaxPly && ScoreMate - std::abs(score) <= _depth) return true;
+    return _useTime && _time.stopAfterIteration(_result.bestMove, score);
+}
+
+void Search::finishSearch()
+{
+    _finished = true;
+    _result.nodes = nodes();
+    _result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _startTime).count();
+    _result.tt = _ttStats;
+    _result.pawns = _pawns.stats();
+    _result.threadNodes.assign(1, _result.nodes);
+    _result.thread = _threadIndex;
+}
+
+bool Search::sliceExpired() const
+{
+    if (!_sliceLimited) return false;
+    const uint64_t count = nodes();
+    if (count == _sliceStartNodes) return false;   // every slice makes some progress
+    if (count >= _sliceEndNodes) return true;
+    return (count % SlicePollNodes) == 0 && std::chrono::steady_clock::now() >= _sliceEnd;
+}
+
+void Search::checkLimits()
+{
+    // ponder hit: the time control applies from now, the pondering time was free
+    if (_pondering && _limits.ponderHit->load(std::memory_order_acquire)) {
+        _pondering = false;
+        _time.start(_limits);
+        _useTime = _threadIndex == 0 && _time.enabled();
+        _result.softLimitMs = _time.softLimitMs();
+        _result.hardLimitMs = _time.hardLimitMs();
+    }
+    if ((_limits.maxNodes && nodes() >= _limits.maxNodes) || (_useTime && _time.hardLimitReached())) {
+        _stop.store(true, std::memory_order_relaxed);
+    }
+}
+
+// the network when one is loaded, otherwise the piece-square evaluation
+int Search::staticEval()
+{
+    return _useNnue ? _nnue.evaluate(_pos) : evaluate(_pos, _pawns);
+}
+
+// fifty-move rule and repetition; the search treats the first repetition as a draw
+bool Search::isDraw() const
+{
+    return _pos.halfmoveClock() >= 100 || _pos.repetitions() > 0;
+}
+
+//
+// The search loop. Each pass either enters the top frame (a node not yet looked at) or
+// resumes it after its child returned; a node that is done hands its score to its parent.
+// Entering a node is the only place the loop can pause, so a paused search resumes
+// exactly where it left off.
+//
+Search::RunState Search::run()
+{
+    int value = 0;   // score of the node that just returned, from its side to move's view
+    for (;;) {
+        Frame& node = _stack[_ply];
+        bool done;
+        if (!node.entered) {
+            if (sliceExpired()) return RunState::Paused;
+            node.entered = true;
+            done = enterNode(node, value);
+            if (_stop.load(std::memory_order_relaxed)) return RunState::Aborted;
+        } else {
+            _pos.unmakeMove();
+            done = childReturned(node, -value);
+            if (done) value = finishNode(node);
+        }
+
+        if (!done) {
+            if (pushChild(node)) continue;
+            value = finishNode(node);
+        }
+
+        if (_ply == 0) {
+            _rootScore = value;
+            return RunState::Done;
+        }
+        _ply--;
+    }
+}
+
+// Node entry: returns true with value set when the node is resolved without searching
+// moves (draw, mate distance, transposition table cutoff, mate/stalemate, horizon)
+bool Search::enterNode(Frame& node, int& value)
+{
+    if (node.quiescence) return enterQuiescence(node, value);
+
+    const int ply = _ply;
+    _pvLength[ply] = 0;
+
+    const uint64_t nodeCount = _nodes.load(std::memory_order_relaxed);
+    if ((nodeCount & (TimeManager::PollInterval - 1)) == 0) checkLimits();
+    if (_stop.load(std::memory_order_relaxed)) return true;
+    _nodes.store(nodeCount + 1, std::memory_order_relaxed);
+
+    const bool rootNode = ply == 0;
+    if (!rootNode) {
+        if (isDraw()) {
+            value = ScoreDraw;
+            return true;
+        }
+        // mate distance pruning: no line from here can beat a mate already found nearer the root
+        node.alpha = std::max(node.alpha, -ScoreMate + ply);
+        node.beta = std::min(node.beta, ScoreMate - ply - 1);
+        if (node.alpha >= node.beta) {
+            value = node.alpha;
+            return true;
+        }
+    }
+
+    node.checked = inCheck(_pos);
+    if (node.checked) node.depth++;   // check extension
+
+    if (ply >= MaxPly) {
+        value = staticEval();
+        return true;
+    }
+    if (node.depth <= 0) {
+        node.quiescence = true;
+        return enterQuiescence(node, value);
+    }
+
+    const bool pvNode = node.beta - node.alpha > 1;
+    node.key = _pos.key();
+    TTData tte;
+    BitMove ttMove = BitMove::none();
+    if (_tt.probe(node.key, tte, &_ttStats)) {
+        ttMove = tte.move;
+        const int ttScore = scoreFromTT(tte.score, ply);
+        if (!pvNode && tte.depth >= node.depth &&
+            (tte.bound == BoundExact ||
+             (tte.bound == BoundLower && ttScore >= node.beta) ||
+             (tte.bound == BoundUpper && ttScore <= node.alpha))) {
+            value = ttScore;
+            return true;
+        }
+    }
+
+    node.picker.emplace(_pos, ttMove, _history, ply);
+    if (node.picker->legalCount() == 0) {
+        value = node.checked ? -ScoreMate + ply : ScoreDraw;
+        return true;
+    }
+
+    node.originalAlpha = node.alpha;
+    node.bestScore = -ScoreInfinite;
+    node.bestMove = BitMove::none();
+    node.standPat = -ScoreInfinite;
+    node.quietCount = 0;
+    return false;
+}
+
+//
+// Captures-only search below the horizon. The side to move may "stand pat" on the static
+// evaluation instead of capturing; captures that lose material (SEE < 0) or cannot
+// bring the score back up to alpha (delta pruning) are skipped. In check every evasion
+// is searched, since standing pat is not an option.
+//
+bool Search::enterQuiescence(Frame& node, int& value)
+{
+    const int ply = _ply;
+    _pvLength[ply] = 0;
+
+    const uint64_t nodeCount = _nodes.load(std::memory_order_relaxed);
+    if ((nodeCount & (TimeManager::PollInterval - 1)) == 0) checkLimits();
+    if (_stop.load(std::memory_order_relaxed)) return true;
+    _nodes.store(nodeCount + 1, std::memory_order_relaxed);
+
+    if (ply >= MaxPly) {
+        value = staticEval();
+        return true;
+    }
+
+    const bool pvNode = node.beta - node.alpha > 1;
+    node.key = _pos.key();
+    TTData tte;
+    BitMove ttMove = BitMove::none();
+    int ttEval = ScoreNone;
+    if (_tt.probe(node.key, tte, &_ttStats)) {
+        ttMove = tte.move;
+        ttEval = tte.eval;
+        const int ttScore = scoreFromTT(tte.score, ply);
+        if (!pvNode &&
+            (tte.bound == BoundExact ||
+             (tte.bound == BoundLower && ttScore >= node.beta) ||
+             (tte.bound == BoundUpper && ttScore <= node.alpha))) {
+            value = ttScore;
+            return true;
+        }
+    }
+
+    node.checked = inCheck(_pos);
+    node.standPat = -ScoreInfinite;
+    node.bestScore = -ScoreInfinite;
+    if (!node.checked) {
+        // quiescence entries keep the static evaluation, which saves evaluating again
+        node.standPat = ttEval != ScoreNone ? ttEval : staticEval();
+        if (node.standPat >= node.beta) {
+            value = node.standPat;
+            return true;
+        }
+        node.alpha = std::max(node.alpha, node.standPat);
+        node.bestScore = node.standPat;
+    }
+
+    node.originalAlpha = node.alpha;
+    node.bestMove = BitMove::none();
+    node.quietCount = 0;
+    node.picker.emplace(_pos, ttMove, _history, ply, node.checked ? MovePicker::MainSearch : MovePicker::Quiescence);
+    if (node.checked && node.picker->legalCount() == 0) {
+        value = -ScoreMate + ply;
+        return true;
+    }
+    return false;
+}
+
+// Make the node's next move worth searching and push its child; false when none is left
+bool Search::pushChild(Frame& node)
+{
+    const bool rootNode = _ply == 0;
+    for (BitMove move = node.picker->next(); !move.isNull(); move = node.picker->next()) {
+        if (node.quiescence) {
+            if (!node.checked && !move.isPromotion()) {
+                const int victim = move.isEnPassant() ? Pawn : pieceTypeOf(_pos.pieceAt(move.to()));
+                if (node.standPat + PieceValue[victim] + DeltaMargin <= node.alpha) continue;
+            }
+        } else {
+            node.quiet = !move.isCapture() && !move.isPromotion();
+            // shallow nodes skip captures that lose more material than the remaining depth could win back
+            if (!rootNode && !node.checked && !node.quiet && node.depth <= 6 && node.bestScore > -ScoreMateInMaxPly &&
+                !see(_pos, move, -100 * node.depth)) {
+                continue;
+            }
+        }
+
+        node.move = move;
+        _pos.makeMove(move);
+        _tt.prefetch(_pos.key());
+
+        Frame& child = _stack[_ply + 1];
+        child.alpha = -node.beta;
+        child.beta = -node.alpha;
+        child.depth = node.depth - 1;
+        child.quiescence = node.quiescence;
+        child.entered = false;
+        _ply++;
+        return true;
+    }
+    return false;
+}
+
+// The child searched for node.move scored score (from this node's side); true on a beta cutoff
+bool Search::childReturned(Frame& node, int score)
+{
+    const int ply = _ply;
+    const BitMove move = node.move;
+    if (score > node.bestScore) {
+        node.bestScore = score;
+        node.bestMove = move;
+        if (score > node.alpha) {
+            node.alpha = score;
+            // PV: this move followed by the child's line
+            _pv[ply][0] = move;
+            std::copy(_pv[ply + 1], _pv[ply + 1] + _pvLength[ply + 1], _pv[ply] + 1);
+            _pvLength[ply] = _pvLength[ply + 1] + 1;
+            if (node.alpha >= node.beta) {
+                if (!node.quiescence && node.quiet) updateQuietHistory(move, node.depth, ply, node.quietsTried, node.quietCount);
+                return true;
+            }
+        }
+    }
+    if (!node.quiescence && node.quiet && node.quietCount < 64) node.quietsTried[node.quietCount++] = move;
+    return false;
+}
+
+// All moves searched (or a cutoff): store the result and return the node's score
+int Search::finishNode(Frame& node)
+{
+    const TTBound bound = node.bestScore >= node.beta ? BoundLower
+                        : (node.bestScore > node.originalAlpha ? BoundExact : BoundUpper);
+    if (node.quiescence) {
+        _tt.store(node.key, node.bestMove, scoreToTT(node.bestScore, _ply),
+                  node.standPat == -ScoreInfinite ? ScoreNone : node.standPat, 0, bound, &_ttStats);
+    } else {
+        _tt.store(node.key, node.bestMove, scoreToTT(node.bestScore, _ply), ScoreNone, node.depth, bound, &_ttStats);
+    }
+    return node.bestScore;
+}
+
+// A quiet move caused a beta cutoff: make it a killer and the countermove to the
+// opponent's last move, reward its history and penalise the quiets tried before it.
+void Search::updateQuietHistory(BitMove best, int depth, int ply, const BitMove* quiets, int quietCount)
+{
+    const int side = _pos.sideToMove();
+    const int bonus = std::min(16 * depth * depth, 1600);
+
+    if (ply < HistoryMaxPly && _history.killers[ply][0] != best) {
+        _history.killers[ply][1] = _history.killers[ply][0];
+        _history.killers[ply][0] = best;
+    }
+
+    const BitMove prev = _pos.lastMove();
+    const int prevPiece = prev.isNull() ? -1 : SearchHistory::pieceIndex(_pos.pieceAt(prev.to()));
+    if (prevPiece >= 0) _history.counterMoves[prevPiece][prev.to()] = best;
+
+    auto reward = [&](BitMove move, int amount) {
+        SearchHistory::update(_history.butterfly[side][move.from()][move.to()], amount);
+        if (prevPiece >= 0) {
+            const int piece = SearchHistory::pieceIndex(_pos.pieceAt(move.from()));
+            SearchHistory::update(_history.continuation[prevPiece][prev.to()][piece][move.to()], amount);
+        }
+    };
+    reward(best, bonus);
+    for (int i = 0; i < quietCount; i++) reward(quiets[i], -bonus);
+}
+
+SearchThreads::SearchThreads(TranspositionTable& tt, int threads) : _tt(tt)
+{
+    setThreadCount(threads);
+}
+
+void SearchThreads::setThreadCount(int threads)
+{
+    threads = std::clamp(threads, 1, 256);
+    _workers.clear();
+    for (int i = 0; i < threads; i++) {
+        _workers.push_back(std::make_unique<Search>(_tt, i));
+    }
+}
+
+void SearchThreads::stop()
+{
+    for (auto& worker : _workers) worker->stop();
+}
+
+SearchResult SearchThreads::think(const Position& pos, const SearchLimits& limits)
+{
+    _tt.newSearch();
+
+    Search& main = *_workers[0];
+    main.setIterationCallback([this](const SearchResult& iteration) {
+        if (!_onIteration) return;
+        SearchResult report = iteration;
+        report.nodes = 0;
+        report.threadNodes.clear();
+        for (auto& worker : _workers) {
+            report.threadNodes.push_back(worker->nodes());
+            report.nodes += report.threadNodes.back();
+        }
+        _onIteration(report);
+    });
+
+    std::vector<SearchResult> results(_workers.size());
+    std::vector<std::atomic<bool>> done(_workers.size());
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < _workers.size(); i++) {
+        helpers.emplace_back([&, i]() {
+            results[i] = _workers[i]->think(pos, limits);
+            done[i].store(true, std::memory_order_release);
+        });
+    }
+
+    results[0] = main.think(pos, limits);
+    // Helpers ignore the clock, and one that has not reached start() yet clears a stop sent
+    // before it, so keep stopping each helper until it reports done
+    for (size_t i = 1; i < _workers.size(); i++) _workers[i]->stop();
+    for (size_t i = 1; i < _workers.size(); i++) {
+        while (!done[i].load(std::memory_order_acquire)) {
+            _workers[i]->stop();
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread& helper : helpers) helper.join();
+
+    size_t best = 0;
+    for (size_t i = 1; i < results.size(); i++) {
+        if (results[i].depth > results[best].depth && !results[i].pv.empty()) best = i;
+    }
+
+    SearchResult result = results[best];
+    result.seconds = results[0].seconds;
+    result.nodes = 0;
+    result.threadNodes.clear();
+    result.tt = TTStats();
+    result.pawns = PawnHashStats();
+    for (const SearchResult& r : results) {
+        result.threadNodes.push_back(r.nodes);
+        result.nodes += r.nodes;
+        result.tt += r.tt;
+        result.pawns += r.pawns;
+    }
+    return result;
+}
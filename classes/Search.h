@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "Bitboard.h"
+#include "MovePicker.h"
+#include "Nnue.h"
+#include "PawnTable.h"
+#include "Position.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+
+constexpr int MaxPly = 128;
+constexpr int ScoreDraw = 0;
+constexpr int ScoreMate = 32000;
+constexpr int ScoreInfinite = 32001;
+constexpr int ScoreNone = 32002;
+// scores beyond this are "mate in n" and get ply-adjusted in the transposition table
+constexpr int ScoreMateInMaxPly = ScoreMate - MaxPly;
+// a capture that cannot lift the stand-pat score this close to alpha is not searched
+constexpr int DeltaMargin = 200;
+
+struct SearchLimits
+{
+    int maxDepth = 64;        // deepest iteration
+    uint64_t maxNodes = 0;    // 0 = no node limit (counted per thread)
+    // time control; with neither a move time nor a clock the search is untimed
+    int64_t moveTimeMs = 0;   // fixed budget for this move
+    int64_t timeLeftMs = 0;   // clock of the side to move
+    int64_t incrementMs = 0;
+    int movesToGo = 0;        // moves until the next time control, 0 = rest of the game
+    // Pondering: while this caller-owned flag is false the search ignores the time control;
+    // once the caller sets it (the predicted move was played) the clock starts from then
+    const std::atomic<bool>* ponderHit = nullptr;
+};
+
+struct SearchResult
+{
+    BitMove bestMove = BitMove::none();
+    int score = 0;
+    int depth = 0;            // last fully searched iteration
+    uint64_t nodes = 0;       // all threads
+    double seconds = 0.0;
+    int64_t softLimitMs = 0;  // the time manager's limits, 0 when untimed
+    int64_t hardLimitMs = 0;
+    std::vector<BitMove> pv;  // principal variation, starting with bestMove
+    TTStats tt;
+    PawnHashStats pawns;      // pawn structure cache, summed over threads
+    std::vector<uint64_t> threadNodes;
+    int thread = 0;           // which thread's result was picked
+
+    double nps() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+//
+// Negamax alpha-beta with iterative deepening. Each iteration re-searches from the
+// root one ply deeper; the transposition table carries the previous iteration's best
+// moves forward so they are tried first, and MovePicker orders the rest using the
+// killer/countermove/history tables updated here on cutoffs. At depth 0 a quiescence
+// search resolves captures so the static evaluation is only taken in quiet positions.
+// A triangular table collects the principal
+// variation. Only completed iterations are reported, so stopping early (node limit, the
+// time manager's hard limit or stop()) still returns the best move of the last finished depth.
+// One Search is one thread's worth of state; SearchThreads below runs several.
+//
+// The tree is walked with an explicit stack of Frames rather than recursion, so the search
+// can pause between any two nodes and carry on later: step() searches for a slice of time
+// or nodes and returns, which lets a single-threaded caller (a UI frame loop) interleave
+// the search with other work. think() is start() plus step() without a budget.
+//
+class Search
+{
+public:
+    using IterationCallback = std::function<void(const SearchResult&)>;
+
+    explicit Search(TranspositionTable& tt, int threadIndex = 0) : _tt(tt), _threadIndex(threadIndex) { }
+
+    // the caller ages the transposition table (TranspositionTable::newSearch) once per move
+    SearchResult think(const Position& pos, const SearchLimits& limits);
+
+    // Cooperative use: start() sets the search up, each step() searches until its budget
+    // (microseconds and/or nodes, 0 = unlimited) is spent and returns true once the search
+    // has finished; result() holds the answer from then on. A node budget makes the
+    // slices, and so the whole search, deterministic.
+    void start(const Position& pos, const SearchLimits& limits);
+    bool step(int64_t budgetMicros, uint64_t budgetNodes = 0);
+    const SearchResult& result() const { return _result; }
+
+    // safe to call from another thread while think() runs
+    void stop() { _stop.store(true, std::memory_order_relaxed); }
+    uint64_t nodes() const { return _nodes.load(std::memory_order_relaxed); }
+
+    // called after every completed iteration (UI/UCI progress)
+    void setIterationCallback(IterationCallback callback) { _onIteration = std::move(callback); }
+
+private:
+    // One node of the search stack: its window and the state of its move loop
+    struct Frame
+    {
+        int alpha;
+        int beta;
+        int depth;
+        int originalAlpha;
+        int bestScore;
+        int standPat;
+        uint64_t key;
+        BitMove bestMove;
+        BitMove move;             // the move being searched below this node
+        bool quiescence;
+        bool entered;             // false until the node's entry code has run
+        bool checked;
+        bool quiet;               // move is not a capture or promotion
+        int quietCount;
+        BitMove quietsTried[64];
+        std::optional<MovePicker> picker;
+    };
+
+    enum class RunState { Done, Paused, Aborted };
+
+    RunState run();
+    bool enterNode(Frame& node, int& value);
+    bool enterQuiescence(Frame& node, int& value);
+    bool pushChild(Frame& node);
+    bool childReturned(Frame& node, int score);
+    int finishNode(Frame& node);
+    bool iterationCompleted(int score);
+    void finishSearch();
+    bool sliceExpired() const;
+    int staticEval();
+    bool isDraw() const;
+    void checkLimits();
+    void updateQuietHistory(BitMove best, int depth, int ply, const BitMove* quiets, int quietCount);
+
+    TranspositionTable& _tt;
+    IterationCallback _onIteration;
+    SearchLimits _limits;
+    Position _pos;
+    TTStats _ttStats;
+    SearchHistory _history;
+    TimeManager _time;
+    bool _useTime = false;    // main thread of a timed search; helpers are stopped by SearchThreads
+    PawnTable _pawns;
+    NnueAccumulator _nnue;
+    bool _useNnue = false;    // a network was loaded when this search started
+    bool _pondering = false;  // untimed until *_limits.ponderHit is set
+    const int _threadIndex;
+    // only this thread writes it; atomic so other threads can read a live total
+    std::atomic<uint64_t> _nodes{ 0 };
+    std::atomic<bool> _stop{ false };
+
+    // triangular PV table: _pv[ply] holds the line found from ply onward
+    BitMove _pv[MaxPly + 1][MaxPly + 1];
+    int _pvLength[MaxPly + 1];
+
+    // search stack; _ply is the top frame, -1 between iterations
+    Frame _stack[MaxPly + 1];
+    int _ply = -1;
+    int _depth = 0;           // iteration in progress
+    int _maxDepth = 0;
+    int _rootScore = 0;
+    bool _finished = true;
+    SearchResult _result;
+    std::chrono::steady_clock::time_point _startTime;
+
+    // current step()'s budget
+    bool _sliceLimited = false;
+    std::chrono::steady_clock::time_point _sliceEnd;
+    uint64_t _sliceStartNodes = 0;
+    uint64_t _sliceEndNodes = 0;
+};
+
+//
+// Lazy SMP: every thread searches the same root with its own Search, and they only
+// cooperate through the shared transposition table. Helper threads skip every other
+// iteration depth (odd helpers the even depths, even helpers the odd ones) so they run
+// ahead of the main thread and fill the table with deeper results. The main thread runs
+// on the caller; when it finishes, the helpers are stopped and the deepest completed
+// result wins (ties go to the main thread).
+//
+class SearchThreads
+{
+public:
+    explicit SearchThreads(TranspositionTable& tt, int threads = 1);
+
+    void setThreadCount(int threads);
+    int threadCount() const { return static_cast<int>(_workers.size()); }
+
+    SearchResult think(const Position& pos, const SearchLimits& limits);
+    void stop();
+
+    // main thread iterations, with nodes summed over every thread
+    void setIterationCallback(Search::IterationCallback callback) { _onIteration = std::move(callback); }
+
+private:
+    TranspositionTable& _tt;
+    std::vector<std::unique_ptr<Search>> _workers;
+    Search::IterationCallback _onIteration;
+};
+
+// mate scores are stored relative to the node, not the root
+inline int scoreToTT(int score, int ply) {
+    if (score >= ScoreMateInMaxPly) return score + ply;
+    if (score <= -ScoreMateInMaxPly) return score - ply;
+    return score;
+}
+
+inline int scoreFromTT(int score, int ply) {
+    if (score >= ScoreMateInMaxPly) return score - ply;
+    if (score <= -ScoreMateInMaxPly) return score + ply;
+    return score;
+}
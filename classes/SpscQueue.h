@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+//
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Each side owns one index and only reads the other's with acquire; the slot write
+// happens before the index store (release), so a popped value is always complete.
+// Each side also caches the other's index so it only touches the shared cache line
+// when the queue looks full (producer) or empty (consumer).
+//
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // producer only; false (and nothing queued) when full
+    bool push(const T& value)
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _headCache == Capacity) {
+            _headCache = _head.load(std::memory_order_acquire);
+            if (tail - _headCache == Capacity) return false;
+        }
+        _slots[tail & (Capacity - 1)] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only; false when empty
+    bool pop(T& out)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tailCache) {
+            _tailCache = _tail.load(std::memory_order_acquire);
+            if (head == _tailCache) return false;
+        }
+        out = _slots[head & (Capacity - 1)];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // consumer side
+    alignas(64) std::atomic<size_t> _head{ 0 };
+    size_t _tailCache = 0;
+    // producer side
+    alignas(64) std::atomic<size_t> _tail{ 0 };
+    size_t _headCache = 0;
+
+    alignas(64) T _slots[Capacity];
+};
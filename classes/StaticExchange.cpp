@@ -0,0 +1,83 @@
+#include "StaticExchange.h"
+#include "Evaluate.h"
+#include "MagicBitboards.h"
+#include "MoveGen.h"
+
+// a king "capture" ends the exchange, so it only needs to outweigh everything else
+static constexpr int SeeKingValue = 20000;
+
+static inline int seeValue(int piece) { return piece == King ? SeeKingValue : PieceValue[piece]; }
+
+bool see(const Position& pos, const BitMove& move, int threshold)
+{
+    // castling never loses material
+    if (move.isCastle()) return 0 >= threshold;
+
+    const int from = move.from();
+    const int to = move.to();
+    const int us = pos.sideToMove();
+
+    int captured = move.isEnPassant() ? Pawn : pieceTypeOf(pos.pieceAt(to));
+    int moving = pieceTypeOf(pos.pieceAt(from));
+    int gain = seeValue(captured);
+    if (move.isPromotion()) {
+        moving = move.promotionPiece();
+        gain += seeValue(moving) - seeValue(Pawn);
+    }
+
+    // swap is what we are ahead by after each capture, relative to the threshold
+    int swap = gain - threshold;
+    if (swap < 0) return false;
+    // even losing the moving piece for nothing keeps us at the threshold
+    swap = seeValue(moving) - swap;
+    if (swap <= 0) return true;
+
+    uint64_t occupied = pos.occupied() ^ (1ULL << from) ^ (1ULL << to);
+    if (move.isEnPassant()) occupied ^= 1ULL << (to + (us == White ? -8 : 8));
+
+    const uint64_t bishopsQueens = pos.pieces(White, Bishop) | pos.pieces(Black, Bishop) |
+                                   pos.pieces(White, Queen) | pos.pieces(Black, Queen);
+    const uint64_t rooksQueens = pos.pieces(White, Rook) | pos.pieces(Black, Rook) |
+                                 pos.pieces(White, Queen) | pos.pieces(Black, Queen);
+
+    uint64_t attackers = attackersTo(pos, to, occupied) & occupied;
+    int side = us;
+    int result = 1;
+
+    while (true) {
+        side ^= 1;
+        attackers &= occupied;
+        const uint64_t sideAttackers = attackers & pos.occupancy(side);
+        if (!sideAttackers) break;
+
+        // the side that can recapture flips the result unless recapturing loses too much
+        result ^= 1;
+
+        uint64_t bb;
+        if ((bb = sideAttackers & pos.pieces(side, Pawn))) {
+            if ((swap = seeValue(Pawn) - swap) < result) break;
+            occupied ^= bb & (0 - bb);
+            attackers |= getBishopAttacks(to, occupied) & bishopsQueens;
+        } else if ((bb = sideAttackers & pos.pieces(side, Knight))) {
+            if ((swap = seeValue(Knight) - swap) < result) break;
+            occupied ^= bb & (0 - bb);
+        } else if ((bb = sideAttackers & pos.pieces(side, Bishop))) {
+            if ((swap = seeValue(Bishop) - swap) < result) break;
+            occupied ^= bb & (0 - bb);
+            attackers |= getBishopAttacks(to, occupied) & bishopsQueens;
+        } else if ((bb = sideAttackers & pos.pieces(side, Rook))) {
+            if ((swap = seeValue(Rook) - swap) < result) break;
+            occupied ^= bb & (0 - bb);
+            attackers |= getRookAttacks(to, occupied) & rooksQueens;
+        } else if ((bb = sideAttackers & pos.pieces(side, Queen))) {
+            if ((swap = seeValue(Queen) - swap) < result) break;
+            occupied ^= bb & (0 - bb);
+            attackers |= (getBishopAttacks(to, occupied) & bishopsQueens) |
+                         (getRookAttacks(to, occupied) & rooksQueens);
+        } else {
+            // king: legal only if the other side has nothing left to recapture with
+            return (attackers & ~pos.occupancy(side)) ? (result ^ 1) : result;
+        }
+    }
+    return result != 0;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Bitboard.h"
+#include "Position.h"
+
+//
+// Static exchange evaluation: does playing move win at least threshold centipawns once
+// both sides have finished recapturing on its destination square with their least
+// valuable attacker each time? Sliders hidden behind a piece that has just captured
+// (x-rays) join in as the square opens up. Pins are ignored.
+//
+// see(pos, move, 0) is the usual "not a losing capture" test.
+//
+bool see(const Position& pos, const BitMove& move, int threshold);
@@ -0,0 +1,70 @@
+#include "TimeManager.h"
+#include "Search.h"
+#include <algorithm>
+
+// moves assumed left in the game when the clock gives no moves-to-go
+static constexpr int DefaultMovesToGo = 30;
+
+void TimeManager::start(const SearchLimits& limits)
+{
+    _start = std::chrono::steady_clock::now();
+    _lastBest = BitMove::none();
+    _lastScore = 0;
+    _stableIterations = 0;
+    _iterations = 0;
+    _fixedTime = false;
+
+    if (limits.ponderHit && !limits.ponderHit->load(std::memory_order_acquire)) {
+        // pondering: untimed until the hit, when the search starts the time manager again
+        _enabled = false;
+        _softMs = _hardMs = 0;
+    } else if (limits.moveTimeMs > 0) {
+        // a per-move budget: the whole budget is both limits; stopAfterIteration() halves it once
+        _enabled = true;
+        _fixedTime = true;
+        _hardMs = std::max<int64_t>(limits.moveTimeMs - MoveOverheadMs, 1);
+        _softMs = _hardMs;
+    } else if (limits.timeLeftMs > 0) {
+        _enabled = true;
+        const int64_t available = std::max<int64_t>(limits.timeLeftMs - MoveOverheadMs, 1);
+        const int movesToGo = limits.movesToGo > 0 ? std::min(limits.movesToGo, 50) : DefaultMovesToGo;
+        const int64_t optimum = std::min(available / movesToGo + limits.incrementMs * 3 / 4, available);
+        _softMs = std::max<int64_t>(optimum, 1);
+        // never more than a few times the target, and never so much of the clock that the next moves starve
+        _hardMs = std::max<int64_t>(std::min(optimum * 4, movesToGo == 1 ? available : available / 3), _softMs);
+    } else {
+        _enabled = false;
+        _softMs = _hardMs = 0;
+    }
+}
+
+int64_t TimeManager::elapsedMs() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start).count();
+}
+
+bool TimeManager::stopAfterIteration(BitMove bestMove, int score)
+{
+    if (!_enabled) return false;
+
+    _iterations++;
+    _stableIterations = (_iterations > 1 && bestMove == _lastBest) ? _stableIterations + 1 : 0;
+    const bool scoreDropped = _iterations > 1 && score < _lastScore - 30;
+    _lastBest = bestMove;
+    _lastScore = score;
+
+    // the budget was fixed by the caller: no stretching or shrinking
+    if (_fixedTime) return elapsedMs() >= _softMs / 2;
+
+    // a best move that just changed needs more time to settle; one that has held for several iterations less
+    double scale = 1.0;
+    if (_stableIterations == 0) scale = 1.5;
+    else if (_stableIterations >= 4) scale = 0.5;
+    else if (_stableIterations >= 2) scale = 0.75;
+    if (scoreDropped) scale *= 1.3;
+
+    const int64_t target = std::min(static_cast<int64_t>(_softMs * scale), _hardMs);
+    // the next iteration usually takes longer than all the previous ones together, so
+    // starting it past half the target mostly wastes time until the hard limit
+    return elapsedMs() >= target / 2;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include "Bitboard.h"
+
+struct SearchLimits;
+
+//
+// Decides how long one move may think. From the clock inputs in SearchLimits it derives
+//   - a soft limit: the time the move should take; no new iteration is started once
+//     half of it has passed, since that iteration would likely run past it, and
+//   - a hard limit: the search is aborted mid-iteration when it is reached.
+// The soft limit stretches while the best move keeps changing or the score drops, and
+// shrinks once the best move has stayed the same for a few iterations. A fixed move time
+// is the one exception: its soft limit is the whole budget and does not move, so the
+// search uses between half of it and all of it. The search polls
+// the hard limit every PollInterval nodes, so it returns (with the last finished
+// iteration's move) within a fraction of a millisecond of the deadline.
+//
+class TimeManager
+{
+public:
+    static constexpr uint64_t PollInterval = 1024;  // nodes between clock checks, a power of two
+    static constexpr int64_t MoveOverheadMs = 20;   // kept back for the caller to apply the move
+
+    void start(const SearchLimits& limits);
+    bool enabled() const { return _enabled; }
+
+    int64_t elapsedMs() const;
+    bool hardLimitReached() const { return _enabled && elapsedMs() >= _hardMs; }
+
+    // after each completed iteration; true when the next iteration should not be started
+    bool stopAfterIteration(BitMove bestMove, int score);
+
+    int64_t softLimitMs() const { return _softMs; }
+    int64_t hardLimitMs() const { return _hardMs; }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+    bool _enabled = false;
+    int64_t _softMs = 0;
+    int64_t _hardMs = 0;
+    bool _fixedTime = false;  // per-move budget rather than a clock
+
+    BitMove _lastBest = BitMove::none();
+    int _lastScore = 0;
+    int _stableIterations = 0;
+    int _iterations = 0;
+};
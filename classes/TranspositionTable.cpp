@@ -0,0 +1,129 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+{
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes)
+{
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= std::max<size_t>(megabytes, 1) * 1024 * 1024) count *= 2;
+
+    if (count != _bucketCount) {
+        _buckets.reset();
+        _buckets.reset(new Bucket[count]);
+        _bucketCount = count;
+        _mask = count - 1;
+    }
+    clear();
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < _bucketCount; i++) {
+        for (Entry& entry : _buckets[i].entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    _generation = 0;
+}
+
+uint64_t TranspositionTable::pack(BitMove move, int score, int eval, int depth, TTBound bound, uint8_t generation)
+{
+    return static_cast<uint64_t>(move.raw())
+         | static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16
+         | static_cast<uint64_t>(static_cast<uint16_t>(eval)) << 32
+         | static_cast<uint64_t>(static_cast<uint8_t>(std::clamp(depth, -128, 127))) << 48
+         | static_cast<uint64_t>(bound) << 56
+         | static_cast<uint64_t>(generation & GenerationMask) << 58;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTData& out, TTStats* stats) const
+{
+    if (stats) stats->probes++;
+
+    const Bucket& bucket = _buckets[key & _mask];
+    for (const Entry& entry : bucket.entries) {
+        const uint64_t data = entry.data.load(std::memory_order_relaxed);
+        const uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key || data == 0) continue;
+
+        out.move = BitMove::fromRaw(static_cast<uint16_t>(data));
+        out.score = static_cast<int16_t>(data >> 16);
+        out.eval = static_cast<int16_t>(data >> 32);
+        out.depth = entryDepth(data);
+        out.bound = entryBound(data);
+        if (stats) stats->hits++;
+        return true;
+    }
+    return false;
+}
+
+//
+// Replacement: an entry for the same position is overwritten unless it is clearly deeper
+// (then only an exact result replaces it). Otherwise the new data goes into an empty slot,
+// or over the entry with the lowest depth - 8 * age, so stale entries from earlier searches
+// go before shallow ones from this search.
+//
+void TranspositionTable::store(uint64_t key, BitMove move, int score, int eval, int depth, TTBound bound, TTStats* stats)
+{
+    Bucket& bucket = _buckets[key & _mask];
+    Entry* target = nullptr;
+    uint64_t targetData = 0;
+    bool sameKey = false;
+    int worstValue = 0;
+
+    for (Entry& entry : bucket.entries) {
+        const uint64_t data = entry.data.load(std::memory_order_relaxed);
+        const uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if (data == 0 && check == 0) {
+            // first empty slot wins over any occupied one
+            if (!target || targetData != 0) {
+                target = &entry;
+                targetData = 0;
+            }
+            continue;
+        }
+        if ((check ^ data) == key) {
+            target = &entry;
+            targetData = data;
+            sameKey = true;
+            break;
+        }
+        const int value = entryDepth(data) - 8 * entryAge(data);
+        if (!target || (targetData != 0 && value < worstValue)) {
+            target = &entry;
+            targetData = data;
+            worstValue = value;
+        }
+    }
+
+    if (sameKey) {
+        if (bound != BoundExact && depth + 4 <= entryDepth(targetData) && entryAge(targetData) == 0) return;
+        // keep the old best move when this search did not produce one
+        if (move.isNull()) move = BitMove::fromRaw(static_cast<uint16_t>(targetData));
+    } else if (stats && targetData != 0 && entryAge(targetData) == 0) {
+        stats->collisions++;
+    }
+
+    const uint64_t data = pack(move, score, eval, depth, bound, _generation);
+    target->check.store(key ^ data, std::memory_order_relaxed);
+    target->data.store(data, std::memory_order_relaxed);
+    if (stats) stats->stores++;
+}
+
+int TranspositionTable::hashfull() const
+{
+    const size_t sample = std::min<size_t>(_bucketCount, 1000 / BucketEntries);
+    int used = 0;
+    for (size_t i = 0; i < sample; i++) {
+        for (const Entry& entry : _buckets[i].entries) {
+            const uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (data != 0 && entryAge(data) == 0) used++;
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * BucketEntries));
+}
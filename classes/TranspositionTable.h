@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Bitboard.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h>
+#endif
+
+enum TTBound : uint8_t
+{
+    BoundNone  = 0,
+    BoundUpper = 1,   // fail low: score <= stored value
+    BoundLower = 2,   // fail high: score >= stored value
+    BoundExact = 3
+};
+
+// What a probe hands back to the search
+struct TTData
+{
+    BitMove move;
+    int16_t score;
+    int16_t eval;     // static evaluation, stored by quiescence nodes; ScoreNone when unknown
+    int depth;
+    TTBound bound;
+};
+
+// Counters kept by each search thread and summed for reporting, so probing threads
+// never share a counter cache line.
+struct TTStats
+{
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+    uint64_t collisions = 0;   // stores that evicted a different position from the current search
+
+    TTStats& operator+=(const TTStats& other) {
+        probes += other.probes;
+        hits += other.hits;
+        stores += other.stores;
+        collisions += other.collisions;
+        return *this;
+    }
+    double hitRate() const { return probes ? static_cast<double>(hits) / probes : 0.0; }
+    double collisionRate() const { return stores ? static_cast<double>(collisions) / stores : 0.0; }
+};
+
+//
+// Search transposition table shared by every search thread.
+// The table is an array of 64-byte buckets (one cache line) holding 4 entries of two
+// 64-bit words each, written without locks:
+//   data  = move | score << 16 | eval << 32 | depth << 48 | bound << 56 | generation << 58
+//   check = key ^ data
+// A probe only trusts an entry when check ^ data gives back the full key, so an entry
+// torn by a concurrent store reads as a miss instead of a wrong move.
+//
+class TranspositionTable
+{
+public:
+    static constexpr int BucketEntries = 4;
+
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    // reallocates (and clears) the table; the size is rounded down to a power of two buckets
+    void resize(size_t megabytes);
+    void clear();
+    size_t sizeMB() const { return _bucketCount * sizeof(Bucket) / (1024 * 1024); }
+
+    // call once per search so entries from older searches are replaced first
+    void newSearch() { _generation = (_generation + 1) & GenerationMask; }
+
+    bool probe(uint64_t key, TTData& out, TTStats* stats = nullptr) const;
+    void store(uint64_t key, BitMove move, int score, int eval, int depth, TTBound bound, TTStats* stats = nullptr);
+
+    // pull the bucket for key into cache; call right after makeMove so it is there by the probe
+    void prefetch(uint64_t key) const {
+#if defined(_MSC_VER) && !defined(__clang__)
+        _mm_prefetch(reinterpret_cast<const char*>(&_buckets[key & _mask]), _MM_HINT_T0);
+#else
+        __builtin_prefetch(&_buckets[key & _mask]);
+#endif
+    }
+
+    // permill of sampled entries written during the current search (UCI "hashfull")
+    int hashfull() const;
+
+private:
+    static constexpr uint8_t GenerationMask = 0x3F;
+
+    struct Entry
+    {
+        std::atomic<uint64_t> check{ 0 };
+        std::atomic<uint64_t> data{ 0 };
+    };
+
+    struct alignas(64) Bucket
+    {
+        Entry entries[BucketEntries];
+    };
+    static_assert(sizeof(Bucket) == 64, "a bucket must fill exactly one cache line");
+
+    static uint64_t pack(BitMove move, int score, int eval, int depth, TTBound bound, uint8_t generation);
+    static int entryDepth(uint64_t data) { return static_cast<int8_t>((data >> 48) & 0xFF); }
+    static uint8_t entryGeneration(uint64_t data) { return static_cast<uint8_t>(data >> 58); }
+    static TTBound entryBound(uint64_t data) { return static_cast<TTBound>((data >> 56) & 3); }
+    // how many searches ago the entry was written (0..63)
+    int entryAge(uint64_t data) const { return (_generation - entryGeneration(data)) & GenerationMask; }
+
+    std::unique_ptr<Bucket[]> _buckets;
+    size_t _bucketCount = 0;
+    size_t _mask = 0;
+    uint8_t _generation = 0;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <iostream>
 
 class Game;
@@ -14,7 +15,7 @@ typedef enum {
 class Turn
 {
 public:
-	Turn() : _game(nullptr), _player(nullptr), _status(kTurnEmpty), _move(""), _boardState(""), _date(0), _comment(""), _score(0), _replaying(false), _gameNumber(-1) {};
+	Turn() : _game(nullptr), _player(nullptr), _status(kTurnEmpty), _move(""), _moveCode(0), _zobristKey(0), _boardState(""), _date(0), _comment(""), _score(0), _replaying(false), _gameNumber(-1) {};
 	~Turn() {};
 
 	static	Turn *initStartOfGame(Game *game) { Turn *turn = new Turn(); turn->_game = game; turn->_status = kTurnFinished; return turn; };
@@ -23,6 +24,8 @@ public:
 	Player		*_player;
 	TurnStatus	_status;
 	std::string	_move;
+	uint16_t	_moveCode;		// packed move for games that have one (chess BitMove), 0 otherwise
+	uint64_t	_zobristKey;	// position hash after the move (chess), for repetition checks and lookups
 	std::string	_boardState;
 	int			_date;
 	std::string	_comment;
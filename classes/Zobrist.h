@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+//
+// Zobrist hashing keys: one random 64-bit value per (piece, square), plus side to move,
+// each castling-rights combination and each en-passant file. A position key is the XOR
+// of the values for everything present. The table is generated at compile time from a
+// fixed seed so keys are identical across builds and runs.
+//
+struct ZobristKeys
+{
+    uint64_t pieces[12][64];   // indexed like Position's bitboards: white pawn..king, black pawn..king
+    uint64_t side;             // XORed in when black is to move
+    uint64_t castling[16];     // indexed by the CastlingRights bit set
+    uint64_t epFile[8];
+    uint64_t noPawns;          // starting value of the pawn key, so a pawnless key is never 0
+
+    constexpr ZobristKeys() : pieces(), side(0), castling(), epFile(), noPawns(0) {
+        uint64_t seed = 0x9E3779B97F4A7C15ULL;
+        for (int p = 0; p < 12; p++) {
+            for (int sq = 0; sq < 64; sq++) {
+                pieces[p][sq] = next(seed);
+            }
+        }
+        side = next(seed);
+        for (int i = 0; i < 16; i++) castling[i] = next(seed);
+        castling[0] = 0;
+        for (int f = 0; f < 8; f++) epFile[f] = next(seed);
+        noPawns = next(seed);
+    }
+
+private:
+    // xorshift64*
+    static constexpr uint64_t next(uint64_t& s) {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 2685821657736338717ULL;
+    }
+};
+
+inline constexpr ZobristKeys Zobrist;
+
+class Position;
+
+// Full key computed from scratch
+uint64_t computeZobristKey(const Position& pos);
+// Pawn-only key (both colours' pawns) computed from scratch
+uint64_t computePawnKey(const Position& pos);
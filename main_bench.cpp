@@ -0,0 +1,476 @@
+// Headless benchmarks for the chess engine code (no ImGui / GLFW).
+//
+//   chess-bench [iterations]                 slider benchmark
+//   chess-bench search [depth] [threads]     search benchmark
+//   chess-bench nnue [weights.nnue]          evaluation benchmark
+//   chess-bench movetime [ms] [threads]      time manager check
+//   chess-bench sliced [depth] [slice us]    time-sliced search check
+//   chess-bench speculate [replies] [ms]     speculative reply search hit rate
+//   chess-bench endgame                      known-endgame verdict check
+//
+// slider: sliding-piece move generation, square-by-square ray walker vs magic bitboard lookups
+// search: fixed-depth search of the bench positions, 1 thread vs Lazy SMP with N threads
+// nnue:   evaluations/s at every node of a make/unmake tree walk, PST vs NNUE (random
+//         weights unless a network file is given)
+// movetime: searches each bench position with a per-move budget and reports how long each took
+//         against the time manager's hard limit; exits non-zero when a move used less than
+//         half of its budget
+// sliced: searches each bench position once in one go and once in step() slices, checks
+//         both give the same move/score/nodes and reports how far slices ran over budget
+// speculate: treats each bench position as the opponent's turn; speculates on the top
+//         replies while a depth 5 search stands in for the opponent choosing its move, then
+//         reports hits and how long the answer took after the opponent's move
+// endgame: evaluates positions the endgame functions must classify as won or drawish and
+//         exits non-zero when one comes out on the wrong side
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "classes/MagicBitboards.h"
+#include "classes/Evaluate.h"
+#include "classes/MoveGen.h"
+#include "classes/Nnue.h"
+#include "classes/Position.h"
+#include "classes/ReplySpeculator.h"
+#include "classes/Search.h"
+#include "classes/TranspositionTable.h"
+
+static const char* kBenchPositions[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+// Reference generator: the original ray walker, one square at a time until the first blocker
+static inline uint64_t rayWalk(int from, int dx, int dy, uint64_t occupied)
+{
+    uint64_t attacks = 0ULL;
+    int x = from % 8 + dx;
+    int y = from / 8 + dy;
+
+    while (x >= 0 && x < 8 && y >= 0 && y < 8) {
+        const uint64_t bit = 1ULL << (y * 8 + x);
+        attacks |= bit;
+        if (occupied & bit) break;
+        x += dx;
+        y += dy;
+    }
+    return attacks;
+}
+
+static inline uint64_t rayWalkRook(int from, uint64_t occupied)
+{
+    return rayWalk(from,  1,  0, occupied) | rayWalk(from, -1,  0, occupied) |
+           rayWalk(from,  0,  1, occupied) | rayWalk(from,  0, -1, occupied);
+}
+
+static inline uint64_t rayWalkBishop(int from, uint64_t occupied)
+{
+    return rayWalk(from,  1,  1, occupied) | rayWalk(from, -1,  1, occupied) |
+           rayWalk(from,  1, -1, occupied) | rayWalk(from, -1, -1, occupied);
+}
+
+static inline void addTargets(MoveList& moves, int from, uint64_t targets)
+{
+    while (targets) {
+        moves.emplace_back(from, popLSB(targets));
+    }
+}
+
+// Sliding-piece moves for both colours, using either the ray walker or magic lookups
+template <bool UseMagic>
+static void generateSliderMoves(const Position& pos, MoveList& moves)
+{
+    const uint64_t occupied = pos.occupied();
+    for (int color = White; color <= Black; color++) {
+        const uint64_t friendly = pos.occupancy(color);
+
+        uint64_t bishops = pos.pieces(color, Bishop);
+        while (bishops) {
+            const int from = popLSB(bishops);
+            const uint64_t atk = UseMagic ? getBishopAttacks(from, occupied) : rayWalkBishop(from, occupied);
+            addTargets(moves, from, atk & ~friendly);
+        }
+        uint64_t rooks = pos.pieces(color, Rook);
+        while (rooks) {
+            const int from = popLSB(rooks);
+            const uint64_t atk = UseMagic ? getRookAttacks(from, occupied) : rayWalkRook(from, occupied);
+            addTargets(moves, from, atk & ~friendly);
+        }
+        uint64_t queens = pos.pieces(color, Queen);
+        while (queens) {
+            const int from = popLSB(queens);
+            const uint64_t atk = UseMagic ? getQueenAttacks(from, occupied)
+                                          : (rayWalkRook(from, occupied) | rayWalkBishop(from, occupied));
+            addTargets(moves, from, atk & ~friendly);
+        }
+    }
+}
+
+template <bool UseMagic>
+static double benchSliders(const std::vector<Position>& positions, int iterations, uint64_t& totalMoves)
+{
+    MoveList moves;
+    totalMoves = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (const Position& pos : positions) {
+            moves.clear();
+            generateSliderMoves<UseMagic>(pos, moves);
+            totalMoves += moves.size();
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+static void sliderBenchmark(const std::vector<Position>& positions, int iterations)
+{
+    uint64_t rayMoves = 0;
+    uint64_t magicMoves = 0;
+    const double raySeconds = benchSliders<false>(positions, iterations, rayMoves);
+    const double magicSeconds = benchSliders<true>(positions, iterations, magicMoves);
+
+    const double rayRate = rayMoves / raySeconds;
+    const double magicRate = magicMoves / magicSeconds;
+
+    std::printf("slider move generation (%d iterations x %zu positions)\n", iterations, positions.size());
+    std::printf("  ray walker : %12llu moves  %8.3f s  %14.0f moves/s\n", (unsigned long long)rayMoves, raySeconds, rayRate);
+    std::printf("  magic      : %12llu moves  %8.3f s  %14.0f moves/s\n", (unsigned long long)magicMoves, magicSeconds, magicRate);
+    std::printf("  speedup    : %.2fx\n", magicRate / rayRate);
+    if (rayMoves != magicMoves) {
+        std::printf("  MISMATCH: generators disagree on the move count\n");
+    }
+}
+
+// Total nodes/time over the bench positions with a fresh 64 MB table per position
+static SearchResult benchSearch(const std::vector<Position>& positions, int depth, int threads, bool verbose)
+{
+    TranspositionTable tt(64);
+    SearchThreads search(tt, threads);
+    SearchLimits limits;
+    limits.maxDepth = depth;
+
+    SearchResult total;
+    total.threadNodes.assign(threads, 0);
+    for (const Position& pos : positions) {
+        tt.clear();
+        const SearchResult result = search.think(pos, limits);
+        if (verbose) {
+            std::printf("  %-6s score %6d  depth %2d  %12llu nodes  (thread %d)\n", moveToUCI(result.bestMove).c_str(),
+                        result.score, result.depth, (unsigned long long)result.nodes, result.thread);
+        }
+        total.nodes += result.nodes;
+        total.seconds += result.seconds;
+        total.tt += result.tt;
+        total.pawns += result.pawns;
+        for (size_t i = 0; i < result.threadNodes.size(); i++) total.threadNodes[i] += result.threadNodes[i];
+    }
+    return total;
+}
+
+static void searchBenchmark(const std::vector<Position>& positions, int depth, int threads)
+{
+    std::printf("search to depth %d (%zu positions)\n", depth, positions.size());
+    std::printf("1 thread\n");
+    const SearchResult single = benchSearch(positions, depth, 1, true);
+    std::printf("  %12llu nodes  %8.3f s  %12.0f nps  tt hits %.1f%%  collisions %.2f%%  pawn hash hits %.1f%%\n",
+                (unsigned long long)single.nodes, single.seconds, single.nps(),
+                100.0 * single.tt.hitRate(), 100.0 * single.tt.collisionRate(), 100.0 * single.pawns.hitRate());
+    if (threads <= 1) return;
+
+    std::printf("%d threads (Lazy SMP)\n", threads);
+    const SearchResult smp = benchSearch(positions, depth, threads, true);
+    for (size_t i = 0; i < smp.threadNodes.size(); i++) {
+        std::printf("  thread %2zu: %12llu nodes\n", i, (unsigned long long)smp.threadNodes[i]);
+    }
+    std::printf("  %12llu nodes  %8.3f s  %12.0f nps  tt hits %.1f%%  collisions %.2f%%  pawn hash hits %.1f%%\n",
+                (unsigned long long)smp.nodes, smp.seconds, smp.nps(),
+                100.0 * smp.tt.hitRate(), 100.0 * smp.tt.collisionRate(), 100.0 * smp.pawns.hitRate());
+    std::printf("  nps scaling %.2fx, time to depth %.2fx\n", smp.nps() / single.nps(), single.seconds / smp.seconds);
+}
+
+static int moveTimeBenchmark(const std::vector<Position>& positions, int64_t moveTimeMs, int threads)
+{
+    TranspositionTable tt(64);
+    SearchThreads search(tt, threads);
+    SearchLimits limits;
+    limits.maxDepth = MaxPly;
+    limits.moveTimeMs = moveTimeMs;
+
+    std::printf("%lld ms per move, %d thread(s)\n", (long long)moveTimeMs, threads);
+    // a fixed move time may stop at half the budget (less the move overhead), never sooner
+    const double earliest = static_cast<double>(moveTimeMs - TimeManager::MoveOverheadMs) / 2.0;
+    double worst = 0.0;
+    int late = 0;
+    int early = 0;
+    for (const Position& pos : positions) {
+        tt.clear();
+        const auto start = std::chrono::steady_clock::now();
+        const SearchResult result = search.think(pos, limits);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("  %-6s depth %2d  %8.1f ms  (soft %lld, hard %lld)\n", moveToUCI(result.bestMove).c_str(), result.depth,
+                    ms, (long long)result.softLimitMs, (long long)result.hardLimitMs);
+        worst = std::max(worst, ms);
+        if (ms > static_cast<double>(moveTimeMs)) late++;
+        if (ms < earliest) early++;
+    }
+    std::printf("  slowest %.1f ms, %d move(s) over the %lld ms budget, %d under half of it\n", worst, late,
+                (long long)moveTimeMs, early);
+    return early ? 1 : 0;
+}
+
+static void slicedBenchmark(const std::vector<Position>& positions, int depth, int64_t sliceMicros)
+{
+    TranspositionTable tt(64);
+    SearchLimits limits;
+    limits.maxDepth = depth;
+
+    std::printf("depth %d in %lld us slices\n", depth, (long long)sliceMicros);
+    int mismatches = 0;
+    uint64_t totalSlices = 0;
+    double totalOverrun = 0.0;
+    double worst = 0.0;
+    for (const Position& pos : positions) {
+        // fresh searches, so both runs start from the same tables and history
+        tt.clear();
+        const SearchResult whole = Search(tt).think(pos, limits);
+
+        tt.clear();
+        Search search(tt);
+        search.start(pos, limits);
+        uint64_t slices = 0;
+        bool finished = false;
+        while (!finished) {
+            const auto start = std::chrono::steady_clock::now();
+            finished = search.step(sliceMicros);
+            const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            slices++;
+            // the last slice of a search usually ends early, which is not an overrun
+            const double overrun = std::max(us - static_cast<double>(sliceMicros), 0.0);
+            totalOverrun += overrun;
+            worst = std::max(worst, overrun);
+        }
+        const SearchResult& sliced = search.result();
+        const bool same = sliced.bestMove == whole.bestMove && sliced.score == whole.score && sliced.nodes == whole.nodes;
+        if (!same) mismatches++;
+        std::printf("  %-6s score %6d  %12llu nodes  %8llu slices  %s\n", moveToUCI(sliced.bestMove).c_str(), sliced.score,
+                    (unsigned long long)sliced.nodes, (unsigned long long)slices, same ? "ok" : "MISMATCH");
+        totalSlices += slices;
+    }
+    std::printf("  %llu slices, overrun mean %.1f us, worst %.0f us, %d mismatch(es)\n", (unsigned long long)totalSlices,
+                totalSlices ? totalOverrun / totalSlices : 0.0, worst, mismatches);
+}
+
+static void speculateBenchmark(const std::vector<Position>& positions, int replies, int64_t moveTimeMs)
+{
+    TranspositionTable tt(64);
+    ReplySpeculator speculator(tt);
+    SearchLimits limits;
+    limits.maxDepth = MaxPly;
+    limits.moveTimeMs = moveTimeMs;
+
+    // the stand-in opponent has its own table, so it does not see the speculative searches' work
+    TranspositionTable opponentTT(16);
+    Search opponent(opponentTT);
+    SearchLimits opponentLimits;
+    opponentLimits.maxDepth = 5;
+
+    std::printf("%d replies, %lld ms per move\n", replies, (long long)moveTimeMs);
+    for (const Position& pos : positions) {
+        tt.clear();
+        opponentTT.clear();
+        speculator.start(pos, limits, replies);
+        const BitMove played = opponent.think(pos, opponentLimits).bestMove;
+
+        const auto start = std::chrono::steady_clock::now();
+        SearchResult answer;
+        const bool hit = speculator.select(played);
+        if (hit) {
+            while (!speculator.takeResult(answer)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("  opponent %-6s %s", moveToUCI(played).c_str(), hit ? "hit " : "miss");
+        if (hit) std::printf("  answer %-6s depth %2d after %7.1f ms", moveToUCI(answer.bestMove).c_str(), answer.depth, ms);
+        std::printf("\n");
+    }
+    const SpeculationStats& stats = speculator.stats();
+    std::printf("  hit rate %.0f%% (%d/%d), %d answered at once, mean latency on hits %.1f ms\n", 100.0 * stats.hitRate(),
+                stats.hits, stats.rounds, stats.immediate, stats.meanLatencyMs());
+}
+
+struct EndgameCase
+{
+    const char* name;
+    const char* fen;
+    int strongSide;
+    bool won;
+};
+
+// A won case must score above WonScore for the strong side, a drawish one at most DrawishScore
+static constexpr int WonScore = 100;
+static constexpr int DrawishScore = 80;
+
+static const EndgameCase kEndgameCases[] = {
+    { "krkp, rook takes the free pawn", "K7/8/8/8/3R4/1p6/8/7k w - - 0 1", White, true },
+    { "krkp, king supports the pawn, attacker cut off", "7K/8/8/8/8/1p6/2k5/7R w - - 0 1", White, false },
+    // the defending king is next to the queening square but five squares from its pawn,
+    // and the attacking king is closer: won, not drawish
+    { "krkp, defender far from its pawn", "8/8/p7/3K4/8/8/3R4/1k6 b - - 0 1", White, true },
+    { "krkp, same with colours reversed", "1K6/3r4/8/8/3k4/P7/8/8 w - - 0 1", Black, true },
+};
+
+static int endgameCheck()
+{
+    int failures = 0;
+    for (const EndgameCase& test : kEndgameCases) {
+        Position pos;
+        pos.setFEN(test.fen);
+        const int score = pos.sideToMove() == test.strongSide ? evaluate(pos) : -evaluate(pos);
+        const bool ok = test.won ? score > WonScore : score <= DrawishScore;
+        if (!ok) failures++;
+        std::printf("  %-50s %6d  %-8s %s\n", test.name, score, test.won ? "won" : "drawish", ok ? "ok" : "WRONG");
+    }
+    std::printf("%s\n", failures ? "ENDGAME CHECK FAILED" : "all endgames classified");
+    return failures ? 1 : 0;
+}
+
+// Calls eval at every node of a fixed-depth tree walk, so incremental evaluators see
+// the same make/unmake pattern as in a search
+template <typename Eval>
+static void walkTree(Position& pos, int depth, Eval& eval, uint64_t& evals, int64_t& checksum)
+{
+    checksum += eval(pos);
+    evals++;
+    if (depth == 0) return;
+
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    for (const BitMove& move : moves) {
+        pos.makeMove(move);
+        walkTree(pos, depth - 1, eval, evals, checksum);
+        pos.unmakeMove();
+    }
+}
+
+template <typename Eval>
+static double benchEval(const std::vector<Position>& positions, int depth, Eval& eval, uint64_t& evals, int64_t& checksum)
+{
+    evals = 0;
+    checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (Position pos : positions) walkTree(pos, depth, eval, evals, checksum);
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+static void nnueBenchmark(const std::vector<Position>& positions, const std::string& weights)
+{
+    std::string path = weights;
+    if (path.empty()) {
+        path = (std::filesystem::temp_directory_path() / "chess-bench-random.nnue").string();
+        if (!NnueNetwork::writeRandom(path, 0x9E3779B97F4A7C15ULL)) {
+            std::printf("could not write %s\n", path.c_str());
+            return;
+        }
+    }
+    if (!loadNnue(path)) {
+        std::printf("could not load network %s\n", path.c_str());
+        return;
+    }
+
+    const int depth = 3;
+    std::printf("static evaluation at every node to depth %d (%zu positions), nnue kernels: %s\n", depth,
+                positions.size(), nnueKernelName());
+
+    uint64_t evals = 0;
+    int64_t checksum = 0;
+    auto pst = [](const Position& pos) { return evaluate(pos); };
+    const double pstSeconds = benchEval(positions, depth, pst, evals, checksum);
+    std::printf("  pst              : %10llu evals  %8.3f s  %12.0f evals/s\n", (unsigned long long)evals, pstSeconds,
+                evals / pstSeconds);
+
+    NnueAccumulator incremental;
+    auto nnue = [&incremental](const Position& pos) { return incremental.evaluate(pos); };
+    int64_t incrementalSum = 0;
+    const double nnueSeconds = benchEval(positions, depth, nnue, evals, incrementalSum);
+    std::printf("  nnue incremental : %10llu evals  %8.3f s  %12.0f evals/s\n", (unsigned long long)evals, nnueSeconds,
+                evals / nnueSeconds);
+
+    // every evaluation rebuilt from scratch: the cost the incremental update avoids
+    NnueAccumulator scratch;
+    auto refresh = [&scratch](const Position& pos) {
+        scratch.reset();
+        return scratch.evaluate(pos);
+    };
+    int64_t refreshSum = 0;
+    const double refreshSeconds = benchEval(positions, depth, refresh, evals, refreshSum);
+    std::printf("  nnue refresh     : %10llu evals  %8.3f s  %12.0f evals/s\n", (unsigned long long)evals, refreshSeconds,
+                evals / refreshSeconds);
+
+    std::printf("  nnue / pst %.2fx, incremental / refresh %.2fx\n", pstSeconds / nnueSeconds, refreshSeconds / nnueSeconds);
+    if (incrementalSum != refreshSum) {
+        std::printf("  MISMATCH: incremental and refreshed accumulators disagree\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    initMoveGenTables();
+
+    std::vector<Position> positions;
+    for (const char* fen : kBenchPositions) {
+        Position pos;
+        pos.setFEN(fen);
+        positions.push_back(pos);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "search") {
+        const int depth = (argc > 2) ? std::atoi(argv[2]) : 6;
+        const int threads = (argc > 3) ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+        searchBenchmark(positions, depth, threads);
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "movetime") {
+        const int64_t ms = (argc > 2) ? std::atoll(argv[2]) : 1000;
+        const int threads = (argc > 3) ? std::atoi(argv[3]) : 1;
+        return moveTimeBenchmark(positions, ms, threads);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "sliced") {
+        const int depth = (argc > 2) ? std::atoi(argv[2]) : 6;
+        const int64_t sliceMicros = (argc > 3) ? std::atoll(argv[3]) : 2000;
+        slicedBenchmark(positions, depth, sliceMicros);
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "speculate") {
+        const int replies = (argc > 2) ? std::atoi(argv[2]) : 4;
+        const int64_t ms = (argc > 3) ? std::atoll(argv[3]) : 500;
+        speculateBenchmark(positions, replies, ms);
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "endgame") {
+        return endgameCheck();
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "nnue") {
+        nnueBenchmark(positions, argc > 2 ? argv[2] : "");
+        return 0;
+    }
+
+    const int iterations = (argc > 1) ? std::atoi(argv[1]) : 200000;
+    sliderBenchmark(positions, iterations);
+    return 0;
+}
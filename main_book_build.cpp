@@ -0,0 +1,667 @@
+// Builds a Polyglot opening book from PGN game collections (no ImGui / GLFW).
+//
+//   book-build [options] <pgn file or directory> <book.bin>
+//
+// Every *.pgn file under the directory is streamed a game at a time. Each game is replayed
+// up to the ply limit and every (position, move) pair in it is counted as a win, draw or
+// loss for the side that played the move. A move's weight is 2 * wins + draws, as in
+// Polyglot's own make-book, scaled per position to fit in 16 bits.
+//
+// options (before the paths):
+//   -r <file>      Polyglot random table (default resources/polyglot_random64.txt)
+//   -p <plies>     plies replayed per game (default 24)
+//   -g <games>     games a move needs to make it into the book (default 2)
+//   -t <threads>   replay threads (0 = all hardware threads, the default)
+//   -m <MB>        memory for the counts before they are spilled to disk (default 512)
+//
+// Memory stays bounded whatever the size of the input. The counts live in a map split by
+// the top bits of the key, so every partition covers its own key range and has its own
+// lock; a partition that outgrows its share of -m is sorted and written out as a run file
+// in <book.bin>.runs. At the end the runs of each partition are k-way merged (partitions in
+// parallel) and the pieces appended in key order, so the book comes out sorted without a
+// global sort. The output does not depend on the number of threads.
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "classes/MoveGen.h"
+#include "classes/Pgn.h"
+#include "classes/PolyglotBook.h"
+#include "classes/Position.h"
+
+namespace fs = std::filesystem;
+
+static const char* kStartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+struct BuildOptions
+{
+    std::string randomPath = "resources/polyglot_random64.txt";
+    int plies = 24;
+    uint32_t minGames = 2;
+    int threads = 0;
+    size_t memoryMB = 512;
+};
+
+static BuildOptions gOptions;
+
+constexpr int PartitionBits = 6;
+constexpr int Partitions = 1 << PartitionBits;
+constexpr size_t FlushRecords = 512;    // records a thread collects per partition before taking its lock
+constexpr size_t MapEntryBytes = 72;    // one map entry with its node, bucket and allocator overhead
+constexpr size_t MaxFanIn = 64;         // runs merged at once
+constexpr size_t ReadBuffer = 1024;     // records buffered per run while merging
+constexpr size_t GamesPerBatch = 64;
+
+// Counts for one (position, move) pair, from the point of view of the side that moved
+struct MoveCount
+{
+    uint64_t key;
+    uint16_t move;
+    uint32_t wins;
+    uint32_t draws;
+    uint32_t losses;
+};
+
+// Run files hold the fields one after another in native byte order (no struct padding),
+// sorted by (key, move); they never leave the machine
+constexpr size_t RunRecordSize = sizeof(uint64_t) + sizeof(uint16_t) + 3 * sizeof(uint32_t);
+
+static void encodeRunRecord(const MoveCount& count, unsigned char* out)
+{
+    std::memcpy(out, &count.key, 8);
+    std::memcpy(out + 8, &count.move, 2);
+    std::memcpy(out + 10, &count.wins, 4);
+    std::memcpy(out + 14, &count.draws, 4);
+    std::memcpy(out + 18, &count.losses, 4);
+}
+
+static MoveCount decodeRunRecord(const unsigned char* in)
+{
+    MoveCount count;
+    std::memcpy(&count.key, in, 8);
+    std::memcpy(&count.move, in + 8, 2);
+    std::memcpy(&count.wins, in + 10, 4);
+    std::memcpy(&count.draws, in + 14, 4);
+    std::memcpy(&count.losses, in + 18, 4);
+    return count;
+}
+
+static bool countLess(const MoveCount& a, const MoveCount& b)
+{
+    return a.key != b.key ? a.key < b.key : a.move < b.move;
+}
+
+static int partitionOf(uint64_t key)
+{
+    return static_cast<int>(key >> (64 - PartitionBits));
+}
+
+[[noreturn]] static void fail(const char* what, const fs::path& path)
+{
+    std::fprintf(stderr, "%s: %s\n", what, path.string().c_str());
+    std::exit(1);
+}
+
+static double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+//
+// Run files
+//
+class RunWriter
+{
+public:
+    explicit RunWriter(const fs::path& path) : _path(path), _file(std::fopen(path.string().c_str(), "wb"))
+    {
+        if (!_file) fail("cannot create", path);
+    }
+    ~RunWriter() { close(); }
+
+    void write(const MoveCount* records, size_t count)
+    {
+        for (size_t i = 0; i < count; i++) {
+            unsigned char bytes[RunRecordSize];
+            encodeRunRecord(records[i], bytes);
+            if (std::fwrite(bytes, RunRecordSize, 1, _file) != 1) fail("write failed", _path);
+        }
+    }
+    void close()
+    {
+        if (_file && std::fclose(_file) != 0) fail("write failed", _path);
+        _file = nullptr;
+    }
+
+private:
+    fs::path _path;
+    std::FILE* _file;
+};
+
+class RunReader
+{
+public:
+    explicit RunReader(const fs::path& path) : _file(std::fopen(path.string().c_str(), "rb"))
+    {
+        if (!_file) fail("cannot open", path);
+        _bytes.resize(ReadBuffer * RunRecordSize);
+        _buffer.resize(ReadBuffer);
+        refill();
+    }
+    ~RunReader() { std::fclose(_file); }
+    RunReader(const RunReader&) = delete;
+    RunReader& operator=(const RunReader&) = delete;
+
+    bool done() const { return _next == _count; }
+    const MoveCount& current() const { return _buffer[_next]; }
+    void advance()
+    {
+        if (++_next == _count) refill();
+    }
+
+private:
+    void refill()
+    {
+        _count = std::fread(_bytes.data(), RunRecordSize, ReadBuffer, _file);
+        for (size_t i = 0; i < _count; i++) _buffer[i] = decodeRunRecord(_bytes.data() + i * RunRecordSize);
+        _next = 0;
+    }
+
+    std::FILE* _file;
+    std::vector<unsigned char> _bytes;
+    std::vector<MoveCount> _buffer;
+    size_t _count = 0;
+    size_t _next = 0;
+};
+
+// k-way merge of sorted runs; equal (key, move) pairs are added up before emit sees them
+static void mergeRuns(const std::vector<fs::path>& runs, const std::function<void(const MoveCount&)>& emit)
+{
+    std::vector<std::unique_ptr<RunReader>> readers;
+    for (const fs::path& run : runs) readers.push_back(std::make_unique<RunReader>(run));
+
+    auto later = [&readers](size_t a, size_t b) { return countLess(readers[b]->current(), readers[a]->current()); };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heads(later);
+    for (size_t i = 0; i < readers.size(); i++) {
+        if (!readers[i]->done()) heads.push(i);
+    }
+
+    bool pending = false;
+    MoveCount sum{};
+    while (!heads.empty()) {
+        const size_t i = heads.top();
+        heads.pop();
+        const MoveCount& next = readers[i]->current();
+        if (pending && next.key == sum.key && next.move == sum.move) {
+            sum.wins += next.wins;
+            sum.draws += next.draws;
+            sum.losses += next.losses;
+        } else {
+            if (pending) emit(sum);
+            sum = next;
+            pending = true;
+        }
+        readers[i]->advance();
+        if (!readers[i]->done()) heads.push(i);
+    }
+    if (pending) emit(sum);
+}
+
+//
+// Counts, partitioned by key range
+//
+class CountTable
+{
+public:
+    CountTable(const fs::path& runDir, size_t partitionLimit) : _runDir(runDir), _partitionLimit(partitionLimit) {}
+
+    // thread-safe; spills the partition once it holds more than its share of entries
+    void add(int index, const std::vector<MoveCount>& records)
+    {
+        Partition& partition = _partitions[index];
+        std::lock_guard<std::mutex> lock(partition.lock);
+        for (const MoveCount& record : records) {
+            Tally& tally = partition.counts[PairKey{record.key, record.move}];
+            tally.wins += record.wins;
+            tally.draws += record.draws;
+            tally.losses += record.losses;
+        }
+        if (partition.counts.size() > _partitionLimit) spill(index, partition);
+    }
+
+    // write out whatever is still in memory, so every count is in a run
+    void spillAll()
+    {
+        for (int i = 0; i < Partitions; i++) {
+            std::lock_guard<std::mutex> lock(_partitions[i].lock);
+            if (!_partitions[i].counts.empty()) spill(i, _partitions[i]);
+        }
+    }
+
+    const std::vector<fs::path>& runs(int index) const { return _partitions[index].runs; }
+    size_t spills() const { return _spills.load(); }
+
+private:
+    struct PairKey
+    {
+        uint64_t key;
+        uint16_t move;
+        bool operator==(const PairKey& other) const { return key == other.key && move == other.move; }
+    };
+    struct PairHash
+    {
+        size_t operator()(const PairKey& pair) const { return pair.key ^ (pair.move * 0x9E3779B97F4A7C15ULL); }
+    };
+    struct Tally
+    {
+        uint32_t wins = 0;
+        uint32_t draws = 0;
+        uint32_t losses = 0;
+    };
+    struct Partition
+    {
+        std::mutex lock;
+        std::unordered_map<PairKey, Tally, PairHash> counts;
+        std::vector<fs::path> runs;
+    };
+
+    // partition lock held
+    void spill(int index, Partition& partition)
+    {
+        std::vector<MoveCount> sorted;
+        sorted.reserve(partition.counts.size());
+        for (const auto& [pair, tally] : partition.counts) {
+            sorted.push_back(MoveCount{pair.key, pair.move, tally.wins, tally.draws, tally.losses});
+        }
+        partition.counts.clear();
+        std::sort(sorted.begin(), sorted.end(), countLess);
+
+        char name[48];
+        std::snprintf(name, sizeof(name), "run-%02d-%zu.bin", index, partition.runs.size());
+        const fs::path path = _runDir / name;
+        RunWriter writer(path);
+        writer.write(sorted.data(), sorted.size());
+        writer.close();
+        partition.runs.push_back(path);
+        _spills++;
+    }
+
+    fs::path _runDir;
+    size_t _partitionLimit;
+    Partition _partitions[Partitions];
+    std::atomic<size_t> _spills{0};
+};
+
+//
+// Book output
+//
+struct BookTotals
+{
+    std::atomic<uint64_t> positions{0};
+    std::atomic<uint64_t> entries{0};
+};
+
+// Turns the merged counts of one partition into book entries. Counts arrive sorted by key,
+// so each position's moves are together and can be weighted against each other.
+class BookPartWriter
+{
+public:
+    BookPartWriter(const fs::path& path, BookTotals& totals)
+        : _path(path), _file(path, std::ios::binary | std::ios::trunc), _totals(totals)
+    {
+        if (!_file) fail("cannot create", path);
+    }
+
+    void add(const MoveCount& count)
+    {
+        if (!_moves.empty() && _moves.front().key != count.key) flushPosition();
+        if (count.wins + count.draws + count.losses >= gOptions.minGames) _moves.push_back(count);
+    }
+    void finish()
+    {
+        flushPosition();
+        _file.close();
+        if (!_file) fail("write failed", _path);
+    }
+
+private:
+    void flushPosition()
+    {
+        std::vector<BookEntry> entries;
+        uint64_t best = 0;
+        for (const MoveCount& count : _moves) {
+            const uint64_t score = 2ULL * count.wins + count.draws;
+            best = std::max(best, score);
+        }
+        for (const MoveCount& count : _moves) {
+            uint64_t score = 2ULL * count.wins + count.draws;
+            if (score == 0) continue;   // never won or drawn: not worth playing
+            if (best > 0xFFFF) score = std::max<uint64_t>(1, score * 0xFFFF / best);
+            entries.push_back(BookEntry{count.key, count.move, static_cast<uint16_t>(score), 0});
+        }
+        _moves.clear();
+        if (entries.empty()) return;
+
+        // heaviest first, like other Polyglot writers; ties stay in move order
+        std::stable_sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) { return a.weight > b.weight; });
+        unsigned char bytes[PolyglotEntrySize];
+        for (const BookEntry& entry : entries) {
+            encodeBookEntry(entry, bytes);
+            _file.write(reinterpret_cast<const char*>(bytes), PolyglotEntrySize);
+        }
+        _totals.positions++;
+        _totals.entries += entries.size();
+    }
+
+    fs::path _path;
+    std::ofstream _file;
+    BookTotals& _totals;
+    std::vector<MoveCount> _moves;
+};
+
+// Merges one partition's runs into a piece of the book, cutting the fan-in down first so
+// no more than MaxFanIn files are open at once
+static fs::path buildPart(int index, std::vector<fs::path> runs, const fs::path& runDir, BookTotals& totals)
+{
+    for (int pass = 0; runs.size() > MaxFanIn; pass++) {
+        std::vector<fs::path> merged;
+        for (size_t first = 0; first < runs.size(); first += MaxFanIn) {
+            const std::vector<fs::path> group(runs.begin() + first, runs.begin() + std::min(runs.size(), first + MaxFanIn));
+            char name[48];
+            std::snprintf(name, sizeof(name), "merge-%02d-%d-%zu.bin", index, pass, merged.size());
+            const fs::path path = runDir / name;
+            RunWriter writer(path);
+            mergeRuns(group, [&writer](const MoveCount& count) { writer.write(&count, 1); });
+            writer.close();
+            for (const fs::path& run : group) fs::remove(run);
+            merged.push_back(path);
+        }
+        runs.swap(merged);
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "part-%02d.bin", index);
+    const fs::path path = runDir / name;
+    BookPartWriter part(path, totals);
+    mergeRuns(runs, [&part](const MoveCount& count) { part.add(count); });
+    part.finish();
+    for (const fs::path& run : runs) fs::remove(run);
+    return path;
+}
+
+//
+// Game replay
+//
+struct ReplayTotals
+{
+    std::atomic<uint64_t> games{0};
+    std::atomic<uint64_t> noResult{0};
+    std::atomic<uint64_t> illegal{0};
+    std::atomic<uint64_t> pairs{0};
+};
+
+// Batches of game texts from the reading thread to the replay threads; bounded, so a slow
+// replay holds the reader back instead of buffering the input
+class GameQueue
+{
+public:
+    explicit GameQueue(size_t capacity) : _capacity(capacity) {}
+
+    void push(std::vector<std::string>&& batch)
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _notFull.wait(lock, [this] { return _batches.size() < _capacity; });
+        _batches.push_back(std::move(batch));
+        _notEmpty.notify_one();
+    }
+    // false once the queue is closed and drained
+    bool pop(std::vector<std::string>& batch)
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _notEmpty.wait(lock, [this] { return !_batches.empty() || _closed; });
+        if (_batches.empty()) return false;
+        batch = std::move(_batches.front());
+        _batches.pop_front();
+        _notFull.notify_one();
+        return true;
+    }
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _closed = true;
+        _notEmpty.notify_all();
+    }
+
+private:
+    std::mutex _lock;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::deque<std::vector<std::string>> _batches;
+    size_t _capacity;
+    bool _closed = false;
+};
+
+static void replayGames(GameQueue& queue, CountTable& table, ReplayTotals& totals)
+{
+    std::vector<MoveCount> pending[Partitions];
+    std::vector<std::string> batch;
+    PgnGame game;
+    Position pos;
+
+    while (queue.pop(batch)) {
+        for (const std::string& text : batch) {
+            if (!parsePgnGame(text, game, gOptions.plies)) continue;
+            totals.games++;
+            if (game.result == PgnResult::Unknown) {
+                totals.noResult++;
+                continue;
+            }
+            if (!pos.setFEN(game.fen.empty() ? kStartFEN : game.fen)) {
+                totals.illegal++;
+                continue;
+            }
+
+            for (const std::string& san : game.moves) {
+                const BitMove move = parseSAN(pos, san);
+                if (move.isNull()) {
+                    // keep what was replayed so far
+                    totals.illegal++;
+                    break;
+                }
+                MoveCount record{polyglotKey(pos), toPolyglotMove(move), 0, 0, 0};
+                if (game.result == PgnResult::Draw) record.draws = 1;
+                else if ((game.result == PgnResult::WhiteWins) == (pos.sideToMove() == White)) record.wins = 1;
+                else record.losses = 1;
+
+                std::vector<MoveCount>& bucket = pending[partitionOf(record.key)];
+                bucket.push_back(record);
+                if (bucket.size() == FlushRecords) {
+                    table.add(partitionOf(record.key), bucket);
+                    bucket.clear();
+                }
+                totals.pairs++;
+                pos.makeMove(move);
+            }
+        }
+    }
+    for (int i = 0; i < Partitions; i++) {
+        if (!pending[i].empty()) table.add(i, pending[i]);
+    }
+}
+
+static std::vector<fs::path> collectInputs(const fs::path& input)
+{
+    std::vector<fs::path> files;
+    if (!fs::is_directory(input)) {
+        files.push_back(input);
+        return files;
+    }
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input)) {
+        if (!entry.is_regular_file()) continue;
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (extension == ".pgn") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// Reads the files a line at a time and hands complete games to the replay threads
+static void readGames(const std::vector<fs::path>& files, GameQueue& queue)
+{
+    std::vector<std::string> batch;
+    std::string line;
+    std::string text;
+    for (const fs::path& path : files) {
+        std::ifstream in(path);
+        if (!in) {
+            std::fprintf(stderr, "cannot open: %s\n", path.string().c_str());
+            continue;
+        }
+        PgnSplitter splitter;
+        bool more = true;
+        while (more) {
+            bool complete;
+            if (std::getline(in, line)) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                complete = splitter.addLine(line, text);
+            } else {
+                complete = splitter.finish(text);
+                more = false;
+            }
+            if (!complete) continue;
+            batch.push_back(std::move(text));
+            text.clear();
+            if (batch.size() == GamesPerBatch) {
+                queue.push(std::move(batch));
+                batch.clear();
+            }
+        }
+    }
+    if (!batch.empty()) queue.push(std::move(batch));
+    queue.close();
+}
+
+static int usage()
+{
+    std::fprintf(stderr,
+                 "usage: book-build [options] <pgn file or directory> <book.bin>\n"
+                 "  -r <file>     Polyglot random table (default resources/polyglot_random64.txt)\n"
+                 "  -p <plies>    plies replayed per game (default 24)\n"
+                 "  -g <games>    games a move needs to make it into the book (default 2)\n"
+                 "  -t <threads>  replay threads (0 = all hardware threads, the default)\n"
+                 "  -m <MB>       memory for the counts before spilling to disk (default 512)\n");
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    int arg = 1;
+    while (arg + 1 < argc && argv[arg][0] == '-') {
+        const std::string flag = argv[arg];
+        const char* value = argv[arg + 1];
+        if (flag == "-r") gOptions.randomPath = value;
+        else if (flag == "-p") gOptions.plies = std::max(1, std::atoi(value));
+        else if (flag == "-g") gOptions.minGames = static_cast<uint32_t>(std::max(1, std::atoi(value)));
+        else if (flag == "-t") gOptions.threads = std::max(0, std::atoi(value));
+        else if (flag == "-m") gOptions.memoryMB = static_cast<size_t>(std::max(1, std::atoi(value)));
+        else return usage();
+        arg += 2;
+    }
+    if (argc - arg != 2) return usage();
+    const fs::path input = argv[arg];
+    const fs::path output = argv[arg + 1];
+
+    initMoveGenTables();
+    if (!loadPolyglotRandom(gOptions.randomPath)) {
+        std::fprintf(stderr, "cannot load the Polyglot random table: %s\n", gOptions.randomPath.c_str());
+        return 1;
+    }
+    if (!polyglotRandomStandard()) {
+        std::printf("warning: %s is not the published Polyglot table; only this engine will read the book\n",
+                    gOptions.randomPath.c_str());
+    }
+
+    const std::vector<fs::path> files = collectInputs(input);
+    if (files.empty()) {
+        std::fprintf(stderr, "no PGN files in %s\n", input.string().c_str());
+        return 1;
+    }
+
+    int threads = gOptions.threads;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    fs::path runDir = output;
+    runDir += ".runs";
+    std::error_code error;
+    fs::create_directories(runDir, error);
+    if (error) fail("cannot create", runDir);
+
+    const size_t partitionLimit = std::max<size_t>(1024, gOptions.memoryMB * 1024 * 1024 / MapEntryBytes / Partitions);
+    const auto start = std::chrono::steady_clock::now();
+
+    CountTable table(runDir, partitionLimit);
+    ReplayTotals replay;
+    {
+        GameQueue queue(2 * static_cast<size_t>(threads));
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; i++) workers.emplace_back(replayGames, std::ref(queue), std::ref(table), std::ref(replay));
+        readGames(files, queue);
+        for (std::thread& worker : workers) worker.join();
+    }
+    const size_t spills = table.spills();
+    table.spillAll();
+    std::printf("files %zu  games %llu  no result %llu  illegal %llu  pairs %llu  spills %zu  time %.3f s\n",
+                files.size(), (unsigned long long)replay.games.load(), (unsigned long long)replay.noResult.load(),
+                (unsigned long long)replay.illegal.load(), (unsigned long long)replay.pairs.load(), spills,
+                secondsSince(start));
+
+    // partitions are disjoint key ranges: merge them in parallel, then append in order
+    BookTotals book;
+    std::vector<fs::path> parts(Partitions);
+    std::atomic<int> nextPartition{0};
+    {
+        std::vector<std::thread> mergers;
+        for (int i = 0; i < std::min(threads, Partitions); i++) {
+            mergers.emplace_back([&]() {
+                for (int index = nextPartition++; index < Partitions; index = nextPartition++) {
+                    parts[index] = buildPart(index, table.runs(index), runDir, book);
+                }
+            });
+        }
+        for (std::thread& merger : mergers) merger.join();
+    }
+
+    {
+        std::ofstream out(output, std::ios::binary | std::ios::trunc);
+        if (!out) fail("cannot create", output);
+        for (const fs::path& part : parts) {
+            std::ifstream in(part, std::ios::binary);
+            if (in.peek() != std::ifstream::traits_type::eof()) out << in.rdbuf();
+        }
+        out.close();
+        if (!out) fail("write failed", output);
+    }
+    fs::remove_all(runDir, error);
+
+    std::printf("positions %llu  entries %llu  time %.3f s  -> %s\n", (unsigned long long)book.positions.load(),
+                (unsigned long long)book.entries.load(), secondsSince(start), output.string().c_str());
+    if (book.entries == 0) std::printf("warning: the book is empty (try a lower -g)\n");
+    return 0;
+}
@@ -0,0 +1,164 @@
+// Headless perft / divide runner for checking the chess move generator (no ImGui / GLFW).
+//
+//   perft <depth> [fen]           count leaf nodes from fen (default: start position)
+//   perft divide <depth> [fen]    same, split by root move
+//   perft suite [max depth]       run the standard reference positions and compare node counts
+//
+// options (before the command):
+//   -t <threads>   split the root across a work-stealing pool (0 = all hardware threads)
+//   -H <MB>        size of the shared perft hash table, only used with -t (default 256, 0 = off)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include "classes/MoveGen.h"
+#include "classes/Perft.h"
+#include "classes/Position.h"
+
+static const char* kStartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+struct PerftOptions
+{
+    int threads = 1;
+    size_t hashMB = 256;
+    bool parallel = false;
+};
+
+static PerftOptions gOptions;
+// shared perft hash table for -t, allocated once and reused by every perft of the run
+static std::unique_ptr<PerftHashTable> gHashTable;
+
+static double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printRate(uint64_t nodes, double seconds)
+{
+    const double nps = seconds > 0.0 ? nodes / seconds : 0.0;
+    std::printf("nodes %llu  time %.3f s  nps %.0f\n", (unsigned long long)nodes, seconds, nps);
+}
+
+// FEN fields arrive as separate arguments; glue them back together
+static std::string joinArgs(int argc, char** argv, int first)
+{
+    std::string out;
+    for (int i = first; i < argc; i++) {
+        if (!out.empty()) out += ' ';
+        out += argv[i];
+    }
+    return out.empty() ? std::string(kStartFEN) : out;
+}
+
+static int runPerft(int depth, const std::string& fen, bool divide)
+{
+    Position pos;
+    if (!pos.setFEN(fen)) {
+        std::fprintf(stderr, "bad fen: %s\n", fen.c_str());
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = 0;
+    if (divide) {
+        for (const PerftDivideEntry& entry : perftDivide(pos, depth)) {
+            std::printf("%s: %llu\n", moveToUCI(entry.move).c_str(), (unsigned long long)entry.nodes);
+            nodes += entry.nodes;
+        }
+        std::printf("\n");
+    } else if (gOptions.parallel) {
+        PerftStats stats;
+        nodes = perftParallel(pos, depth, gOptions.threads, gHashTable.get(), &stats);
+        const double seconds = secondsSince(start);
+        for (size_t i = 0; i < stats.threadNodes.size(); i++) {
+            std::printf("thread %2zu: %14llu nodes  %6llu tasks\n", i,
+                        (unsigned long long)stats.threadNodes[i], (unsigned long long)stats.threadTasks[i]);
+        }
+        if (stats.hashProbes) {
+            std::printf("hash hits %llu / %llu probes (%.1f%%)\n", (unsigned long long)stats.hashHits,
+                        (unsigned long long)stats.hashProbes, 100.0 * stats.hashHits / stats.hashProbes);
+        }
+        printRate(nodes, seconds);
+        return 0;
+    } else {
+        nodes = perft(pos, depth);
+    }
+    printRate(nodes, secondsSince(start));
+    return 0;
+}
+
+static int runSuite(int maxDepth)
+{
+    int failures = 0;
+    uint64_t totalNodes = 0;
+    const auto suiteStart = std::chrono::steady_clock::now();
+
+    for (const PerftReference& ref : perftReferencePositions()) {
+        Position pos;
+        pos.setFEN(ref.fen);
+        for (int depth = 1; depth <= maxDepth && depth <= 7; depth++) {
+            const uint64_t expected = ref.nodes[depth - 1];
+            if (!expected) break;
+
+            const auto start = std::chrono::steady_clock::now();
+            const uint64_t nodes = gOptions.parallel ? perftParallel(pos, depth, gOptions.threads, gHashTable.get())
+                                                     : perft(pos, depth);
+            const double seconds = secondsSince(start);
+            totalNodes += nodes;
+
+            const bool ok = nodes == expected;
+            if (!ok) failures++;
+            std::printf("%-20s depth %d  %12llu  %s  (%.3f s)\n", ref.name, depth,
+                        (unsigned long long)nodes, ok ? "ok" : "FAIL", seconds);
+            if (!ok) {
+                std::printf("    expected %llu\n", (unsigned long long)expected);
+            }
+        }
+    }
+
+    std::printf("\n");
+    printRate(totalNodes, secondsSince(suiteStart));
+    std::printf("%s\n", failures ? "SUITE FAILED" : "all positions match");
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    initMoveGenTables();
+
+    int arg = 1;
+    while (arg + 1 < argc && argv[arg][0] == '-') {
+        const std::string option = argv[arg];
+        if (option == "-t") {
+            gOptions.threads = std::atoi(argv[arg + 1]);
+            gOptions.parallel = true;
+        } else if (option == "-H") {
+            gOptions.hashMB = static_cast<size_t>(std::atoi(argv[arg + 1]));
+        } else {
+            break;
+        }
+        arg += 2;
+    }
+
+    if (arg >= argc) {
+        std::printf("usage:\n"
+                    "  perft [-t threads] [-H MB] <depth> [fen]\n"
+                    "  perft divide <depth> [fen]\n"
+                    "  perft [-t threads] [-H MB] suite [max depth]\n");
+        return 1;
+    }
+
+    if (gOptions.parallel && gOptions.hashMB > 0) gHashTable = std::make_unique<PerftHashTable>(gOptions.hashMB);
+
+    const std::string command = argv[arg];
+    if (command == "suite") {
+        return runSuite(arg + 1 < argc ? std::atoi(argv[arg + 1]) : 5);
+    }
+    if (command == "divide") {
+        if (arg + 1 >= argc) return 1;
+        return runPerft(std::atoi(argv[arg + 1]), joinArgs(argc, argv, arg + 2), true);
+    }
+    return runPerft(std::atoi(argv[arg]), joinArgs(argc, argv, arg + 1), false);
+}
@@ -0,0 +1,348 @@
+// Headless UCI front-end for the chess engine (no ImGui / GLFW), for tournament managers
+// and scripted play. Reads commands from stdin, answers on stdout.
+//
+//   uci, isready, ucinewgame, quit
+//   position [startpos | fen <fen>] [moves <m1> <m2> ...]
+//   go [depth N] [nodes N] [movetime ms] [wtime ms] [btime ms] [winc ms] [binc ms] [movestogo N] [infinite] [ponder]
+//   stop, ponderhit
+//   setoption name Hash value <MB>
+//   setoption name Threads value <N>
+//   setoption name Ponder value <true|false>   (accepted; pondering is driven by "go ponder"; bestmove
+//                                              names the expected reply as "ponder <move>")
+//   setoption name OwnBook value <true|false>  answer "go" from the opening book when possible
+//   setoption name BookFile value <path>       Polyglot .bin book (default resources/book.bin)
+//   bench [depth]                      fixed-depth search of the bench positions, total nodes and nps
+//
+// The search runs on its own thread so "stop" and "isready" are answered while it thinks.
+// At the end of input the last search is allowed to finish, so piped scripts get their bestmove.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "classes/MoveGen.h"
+#include "classes/Nnue.h"
+#include "classes/PolyglotBook.h"
+#include "classes/Position.h"
+#include "classes/Search.h"
+#include "classes/TranspositionTable.h"
+
+static const char* kStartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+static const char* kBenchPositions[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+constexpr int DefaultHashMB = 16;
+constexpr int MaxHashMB = 4096;
+constexpr int MaxThreads = 256;
+
+// the search thread and the command loop both write to stdout
+static std::mutex gOutputMutex;
+
+static void send(const std::string& line)
+{
+    std::lock_guard<std::mutex> lock(gOutputMutex);
+    std::fputs(line.c_str(), stdout);
+    std::fputc('\n', stdout);
+    std::fflush(stdout);
+}
+
+// "cp 34" or "mate 3" (moves, negative when the engine is being mated)
+static std::string uciScore(int score)
+{
+    if (score >= ScoreMateInMaxPly) return "mate " + std::to_string((ScoreMate - score + 1) / 2);
+    if (score <= -ScoreMateInMaxPly) return "mate " + std::to_string(-(ScoreMate + score) / 2);
+    return "cp " + std::to_string(score);
+}
+
+// The legal move written as UCI long algebraic, or a null move
+static BitMove parseMove(const Position& pos, const std::string& text)
+{
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    for (const BitMove& move : moves) {
+        if (moveToUCI(move) == text) return move;
+    }
+    return BitMove::none();
+}
+
+class UciEngine
+{
+public:
+    UciEngine()
+    {
+        _position.setFEN(kStartFEN);
+        _search.setIterationCallback([this](const SearchResult& result) {
+            if (_benchRunning) return;
+            std::ostringstream out;
+            out << "info depth " << result.depth << " score " << uciScore(result.score) << " nodes " << result.nodes
+                << " nps " << static_cast<uint64_t>(result.nps()) << " time " << static_cast<int64_t>(result.seconds * 1000.0)
+                << " hashfull " << _tt.hashfull() << " pv";
+            for (const BitMove& move : result.pv) out << ' ' << moveToUCI(move);
+            send(out.str());
+        });
+    }
+
+    ~UciEngine() { stopSearch(); }
+
+    // false on "quit"
+    bool command(const std::string& line)
+    {
+        std::istringstream in(line);
+        std::string token;
+        if (!(in >> token)) return true;
+
+        if (token == "uci") {
+            send("id name Chess");
+            send("id author Chess project");
+            send("option name Hash type spin default " + std::to_string(DefaultHashMB) + " min 1 max " + std::to_string(MaxHashMB));
+            send("option name Threads type spin default 1 min 1 max " + std::to_string(MaxThreads));
+            send("option name Ponder type check default false");
+            send("option name OwnBook type check default false");
+            send("option name BookFile type string default resources/book.bin");
+            send("uciok");
+        } else if (token == "isready") {
+            send("readyok");
+        } else if (token == "ucinewgame") {
+            stopSearch();
+            _tt.clear();
+        } else if (token == "position") {
+            stopSearch();
+            position(in);
+        } else if (token == "go") {
+            stopSearch();
+            go(in);
+        } else if (token == "stop") {
+            stopSearch();
+        } else if (token == "ponderhit") {
+            // the search goes on under the time control given with "go ponder"
+            _ponderHit.store(true, std::memory_order_release);
+        } else if (token == "setoption") {
+            stopSearch();
+            setOption(in);
+        } else if (token == "bench") {
+            stopSearch();
+            int depth = 6;
+            in >> depth;
+            bench(std::max(depth, 1));
+        } else if (token == "quit") {
+            return false;
+        } else {
+            send("info string unknown command: " + line);
+        }
+        return true;
+    }
+
+    // wait for a running search to report its bestmove ("go infinite" and an unanswered
+    // "go ponder" only end on "stop")
+    void waitForSearch()
+    {
+        if (_infinite || !_ponderHit.load(std::memory_order_acquire)) stopSearch();
+        if (_thread.joinable()) _thread.join();
+    }
+
+private:
+    void position(std::istringstream& in)
+    {
+        std::string token;
+        in >> token;
+        std::string fen;
+        if (token == "startpos") {
+            fen = kStartFEN;
+            in >> token;
+        } else if (token == "fen") {
+            while (in >> token && token != "moves") fen += token + ' ';
+        } else {
+            send("info string expected startpos or fen");
+            return;
+        }
+
+        Position pos;
+        if (!pos.setFEN(fen)) {
+            send("info string invalid fen: " + fen);
+            return;
+        }
+        // the moves go into the position's history, so the search sees repetitions
+        if (token == "moves") {
+            while (in >> token) {
+                const BitMove move = parseMove(pos, token);
+                if (move.isNull()) {
+                    send("info string illegal move: " + token);
+                    break;
+                }
+                pos.makeMove(move);
+            }
+        }
+        _position = pos;
+    }
+
+    void go(std::istringstream& in)
+    {
+        SearchLimits limits;
+        limits.maxDepth = MaxPly - 1;
+        int64_t clock[2] = { 0, 0 };
+        int64_t increment[2] = { 0, 0 };
+        bool infinite = false;
+        bool ponder = false;
+
+        std::string token;
+        while (in >> token) {
+            if (token == "depth") in >> limits.maxDepth;
+            else if (token == "nodes") in >> limits.maxNodes;
+            else if (token == "movetime") in >> limits.moveTimeMs;
+            else if (token == "wtime") in >> clock[White];
+            else if (token == "btime") in >> clock[Black];
+            else if (token == "winc") in >> increment[White];
+            else if (token == "binc") in >> increment[Black];
+            else if (token == "movestogo") in >> limits.movesToGo;
+            else if (token == "infinite") infinite = true;
+            else if (token == "ponder") ponder = true;
+        }
+        const int us = _position.sideToMove();
+        limits.timeLeftMs = clock[us];
+        limits.incrementMs = increment[us];
+        limits.maxDepth = std::clamp(limits.maxDepth, 1, MaxPly - 1);
+        _ponderHit.store(!ponder, std::memory_order_relaxed);
+        if (ponder) limits.ponderHit = &_ponderHit;
+
+        // a book move needs no search (a GUI waiting on "go infinite" or "go ponder" still gets a search)
+        if (_ownBook && !infinite && !ponder) {
+            const BitMove bookMove = openingBook().pick(_position, PolyglotBook::Weighted, _bookRandom());
+            if (!bookMove.isNull()) {
+                send("info string book move");
+                send("bestmove " + moveToUCI(bookMove));
+                return;
+            }
+        }
+
+        _infinite = infinite;
+        _stopRequested.store(false, std::memory_order_relaxed);
+        _searchDone.store(false, std::memory_order_relaxed);
+        _thread = std::thread([this, root = _position, limits, infinite]() {
+            const SearchResult result = _search.think(root, limits);
+            // an infinite or ponder search that ran out of depth (or found a mate) still answers
+            // only on "stop" (or, when pondering, "ponderhit")
+            while ((infinite || !_ponderHit.load(std::memory_order_acquire)) && !_stopRequested.load(std::memory_order_acquire)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            // the expected reply lets the GUI start "go ponder" on our time
+            std::string answer = "bestmove " + moveToUCI(result.bestMove);
+            if (result.pv.size() >= 2 && result.pv[0] == result.bestMove) answer += " ponder " + moveToUCI(result.pv[1]);
+            send(answer);
+            _searchDone.store(true, std::memory_order_release);
+        });
+    }
+
+    void setOption(std::istringstream& in)
+    {
+        // setoption name <id> value <x>
+        std::string token, name, value;
+        in >> token;
+        while (in >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+        std::getline(in >> std::ws, value);
+
+        if (name == "Hash") {
+            _tt.resize(static_cast<size_t>(std::clamp(std::atoi(value.c_str()), 1, MaxHashMB)));
+        } else if (name == "Threads") {
+            _search.setThreadCount(std::clamp(std::atoi(value.c_str()), 1, MaxThreads));
+        } else if (name == "OwnBook") {
+            _ownBook = value == "true";
+        } else if (name == "BookFile") {
+            if (!loadBook(value)) send("info string cannot open book " + value);
+        } else if (name == "Ponder") {
+            // nothing to set up: the GUI sends "go ponder" when it wants the engine to ponder
+        } else {
+            send("info string unknown option: " + name);
+        }
+    }
+
+    void bench(int depth)
+    {
+        SearchLimits limits;
+        limits.maxDepth = depth;
+        _benchRunning = true;
+        uint64_t nodes = 0;
+        double seconds = 0.0;
+        for (const char* fen : kBenchPositions) {
+            Position pos;
+            pos.setFEN(fen);
+            _tt.clear();
+            const SearchResult result = _search.think(pos, limits);
+            nodes += result.nodes;
+            seconds += result.seconds;
+        }
+        std::ostringstream out;
+        out << "bench depth " << depth << " nodes " << nodes << " time " << static_cast<int64_t>(seconds * 1000.0)
+            << " nps " << static_cast<uint64_t>(seconds > 0.0 ? nodes / seconds : 0.0);
+        send(out.str());
+        _tt.clear();
+    }
+
+    // "stop": the search ends with the last finished iteration's move and prints it.
+    // think() clears the stop flag when it starts, so keep asking until it is done.
+    void stopSearch()
+    {
+        if (!_thread.joinable()) return;
+        _stopRequested.store(true, std::memory_order_release);
+        while (!_searchDone.load(std::memory_order_acquire)) {
+            _search.stop();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        _thread.join();
+    }
+
+    TranspositionTable _tt{ DefaultHashMB };
+    SearchThreads _search{ _tt };
+    Position _position;
+    std::thread _thread;
+    std::atomic<bool> _searchDone{ true };
+    std::atomic<bool> _stopRequested{ false };
+    // false while a "go ponder" search waits for "ponderhit"
+    std::atomic<bool> _ponderHit{ true };
+    bool _infinite = false;
+    // bench searches on the command thread; no info lines for it
+    bool _benchRunning = false;
+    bool _ownBook = false;
+    std::mt19937_64 _bookRandom{ std::random_device{}() };
+};
+
+int main(int argc, char** argv)
+{
+    initMoveGenTables();
+    // optional network; without it the engine uses the piece-square evaluation
+    loadNnue("resources/chess.nnue");
+    // the book stays unused without the Polyglot random table (see PolyglotBook.h)
+    if (loadPolyglotRandom("resources/polyglot_random64.txt")) {
+        if (!polyglotRandomStandard()) send("info string polyglot_random64.txt is not the standard Polyglot table");
+        loadBook("resources/book.bin");
+    }
+
+    UciEngine engine;
+    // "chess-uci bench [depth]" runs the benchmark and exits, like other engines
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        engine.command("bench " + std::string(argc > 2 ? argv[2] : "6"));
+        return 0;
+    }
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!engine.command(line)) return 0;
+    }
+    // end of input (a piped script) lets the last "go" finish instead of cutting it short
+    engine.waitForSearch();
+    return 0;
+}